@@ -0,0 +1,130 @@
+#ifndef ACTUATOR_SCHEDULER_H
+#define ACTUATOR_SCHEDULER_H
+
+#include <cstdint>
+#include "pros/rtos.hpp"
+#include "piston.h"
+
+namespace SchedulerConfig {
+    /** @brief Maximum number of commands that can be waiting at once. */
+    constexpr int MAX_COMMANDS = 32;
+
+    /** @brief Number of 1 ms slots in the timer wheel, must be a power of two. */
+    constexpr int WHEEL_SIZE = 256;
+}
+
+/**
+ * @class ActuatorScheduler
+ * @brief Runs piston commands and actions at set times without blocking the route.
+ *
+ * Commands are posted for an absolute time (pros::millis()) or a time relative
+ * to now, and a high priority task runs them from a 1 ms timer wheel. The task
+ * sleeps on a task notification, so posting a command wakes it right away.
+ * Every command records how late it ran so timing jitter can be reported.
+ *
+ * Motors are moved with actions that call whatever owns them, like
+ * intake_controller, so the owner's state and the device cache stay in step
+ * with what the motor is doing.
+ *
+ * @code {.cpp}
+ * intake_controller.move(127);
+ * drivePID(15);
+ * actuator_scheduler.callAfter(270, [] { intake_controller.brake(); }); // route keeps going while the intake runs
+ * @endcode
+ */
+class ActuatorScheduler {
+public:
+    // Actions at an absolute time or a time from now, captureless lambdas work
+    bool callAt(int time, void (*action)());
+    bool callAfter(int msec, void (*action)());
+
+    // Piston commands at an absolute time or a time from now
+    bool extendAt(int time, Piston& piston);
+    bool extendAfter(int msec, Piston& piston);
+    bool retractAt(int time, Piston& piston);
+    bool retractAfter(int msec, Piston& piston);
+
+    /**
+     * @brief Remove every command that has not run yet.
+     */
+    void cancelAll();
+
+    /**
+     * @brief Get the number of commands waiting to run.
+     */
+    int getPendingCount();
+
+    /**
+     * @brief Get the number of commands that have run.
+     */
+    int getRunCount() const;
+
+    /**
+     * @brief Get the latest a command has run, in microseconds.
+     */
+    int getMaxJitter() const;
+
+    /**
+     * @brief Get the average time commands ran late, in microseconds.
+     */
+    double getAverageJitter() const;
+
+    /**
+     * @brief Clear the jitter measurements.
+     */
+    void resetJitter();
+
+    /**
+     * @brief Print the jitter measurements to the terminal.
+     */
+    void printJitter() const;
+
+    /**
+     * @brief Set the task that runs the commands, called by the scheduler task.
+     */
+    void attachTask(pros::task_t task);
+
+    /**
+     * @brief Run every command that is due, called by the scheduler task.
+     *
+     * @return milliseconds the task can sleep before the next command is due
+     */
+    std::uint32_t update();
+
+private:
+    enum class CommandType {
+        CALL,
+        EXTEND,
+        RETRACT
+    };
+
+    struct Command {
+        CommandType type;
+        int time;             ///< when the command should run in milliseconds
+        void (*action)();
+        Piston* piston;
+        Command* next;        ///< next command in the same wheel slot or free list
+    };
+
+    bool post(Command command);
+    void run(const Command& command);
+
+    Command commands[SchedulerConfig::MAX_COMMANDS];
+    Command* wheel[SchedulerConfig::WHEEL_SIZE] = {};
+    Command* freeList = nullptr;
+    bool initialized = false;
+    int pending = 0;
+    int cursor = 0;           ///< last millisecond the wheel has been advanced to
+
+    int runCount = 0;
+    int maxJitter = 0;
+    long long totalJitter = 0;
+
+    pros::task_t task = nullptr;
+    pros::Mutex mutex;
+};
+
+// Task that runs scheduled actuator commands
+void actuator_scheduler_task(void* param);
+
+#endif // ACTUATOR_SCHEDULER_H
@@ -0,0 +1,144 @@
+#ifndef ALLOC_TRACKER_H
+#define ALLOC_TRACKER_H
+
+#include <atomic>
+#include <cstddef>
+#include "pros/rtos.h"
+
+namespace AllocConfig {
+    /** @brief Most tasks allocations are attributed to, later tasks share the last slot. */
+    constexpr int MAX_TASKS = 24;
+
+    /** @brief Most scope tags counted separately. */
+    constexpr int MAX_TAGS = 16;
+
+    /** @brief Length of a task name kept for reports. */
+    constexpr int NAME_LENGTH = 32;
+
+    /** @brief Cycles a guarded loop may allocate in while it warms up. */
+    extern const int WARMUP_CYCLES;
+
+    /** @brief Whether a guarded loop allocating off the field stops the program. */
+    extern const bool ASSERT_OFF_FIELD;
+}
+
+/**
+ * @class AllocTracker
+ * @brief Counts heap allocations per task and per scope tag, and catches allocations in control loops.
+ *
+ * Every operator new and delete in this project's code goes through the
+ * tracker. It never allocates and never locks, since it runs inside the
+ * allocator: each task claims a slot the first time it allocates and is the
+ * only writer of it.
+ *
+ * Only user code is tracked. With USE_PACKAGE the PROS kernel and lemlib are
+ * linked into the cold image with their own operator new, so their
+ * allocations, like lemlib's logger building strings, never reach the tracker.
+ * Plain malloc calls aren't seen either. A loop that only allocates inside a
+ * library call passes LoopGuard, and the counts undercount the heap use the
+ * resource monitor reports.
+ *
+ * A control loop is guarded with LoopGuard. After WARMUP_CYCLES, any
+ * allocation its task makes is a violation, reported at the next tick. Off the
+ * field the program is stopped so it gets fixed, on the field it only warns.
+ *
+ * @note Must stay constant initialized, allocations happen before any constructor runs.
+ */
+class AllocTracker {
+public:
+    struct TaskSlot {
+        std::atomic<bool> claimed = false;
+        std::atomic<bool> ready = false; // task and name are filled in
+        pros::task_t task = nullptr;     // nullptr for allocations before the scheduler starts
+        char name[AllocConfig::NAME_LENGTH] = {};
+        std::atomic<int> allocs = 0;
+        std::atomic<int> frees = 0;
+        std::atomic<long> bytes = 0;
+        const char* tag = nullptr;  // innermost AllocScope, nullptr if none
+        const char* loop = nullptr; // guarded loop running on this task, nullptr if none
+        int cycles = 0;             // ticks of the guarded loop so far
+        std::atomic<int> violations = 0;
+        int reported = 0;           // violations already reported by tick
+        const char* violationTag = nullptr;
+        std::size_t violationSize = 0;
+    };
+
+    struct TagSlot {
+        std::atomic<const char*> tag = nullptr;
+        std::atomic<int> allocs = 0;
+        std::atomic<long> bytes = 0;
+    };
+
+    /**
+     * @brief Count an allocation against the current task, called from operator new.
+     */
+    void recordAlloc(std::size_t size);
+
+    /**
+     * @brief Count a free against the current task, called from operator delete.
+     */
+    void recordFree();
+
+    /**
+     * @brief Gets the slot of the current task, claiming one if it has none.
+     */
+    TaskSlot& currentSlot();
+
+    /**
+     * @brief Gets the number of allocations a task has made.
+     * @return allocations, or -1 if the task has never allocated
+     */
+    int getAllocCount(const char* taskName);
+
+    /**
+     * @brief Print every task's and tag's allocations to the terminal.
+     */
+    void printReport();
+
+    TaskSlot tasks[AllocConfig::MAX_TASKS];
+    TagSlot tags[AllocConfig::MAX_TAGS];
+};
+
+/**
+ * @class AllocScope
+ * @brief Tags every allocation the current task makes while it is alive.
+ *
+ * @code {.cpp}
+ * {
+ *     AllocScope scope("route parse");
+ *     loadRoute();
+ * }
+ * @endcode
+ */
+class AllocScope {
+private:
+    const char* previous;
+
+public:
+    explicit AllocScope(const char* tag);
+    ~AllocScope();
+};
+
+/**
+ * @class LoopGuard
+ * @brief Marks the current task as running a control loop that must not allocate.
+ *
+ * Create it before the loop and call tick once per cycle. tick reports any
+ * allocation made since warm-up ended.
+ */
+class LoopGuard {
+private:
+    const char* previousLoop;
+    int previousCycles;
+
+public:
+    explicit LoopGuard(const char* name);
+    ~LoopGuard();
+
+    /**
+     * @brief End a cycle of the loop, reporting any allocation made in it after warm-up.
+     */
+    void tick();
+};
+
+#endif // ALLOC_TRACKER_H
@@ -3,10 +3,33 @@
 
 
 namespace Goal {
-    extern const int MIN_DETECTION; // Amount of detections needed to quit loop
+    extern const int DETECTION_TIME; // Time the goal has to be detected in a row before clamping, in ms
     extern const int MAX_DISTANCE; // Maximum distance goal is to be counted
+    extern const int STROKE_TIME; // Time for the clamp to close after it fires, in ms
+    extern const int MIN_PROXIMITY; // Proximity where the goal is first trusted to be in view
+    extern const int MIN_CONFIDENCE; // Amount of agreeing samples needed to fire early
 }
 
+// Estimates goal range and closing speed so the clamp can fire before contact
+class GoalPredictor {
+private:
+    int lastTime = -1; // time of the last sample in ms
+    double lastRange = 0; // range at the last sample in inches
+    double sensorSpeed = 0; // closing speed from the proximity trend in inches per second
+    double driveSpeed = 0; // closing speed from the drive motors in inches per second
+    int confidence = 0; // consecutive samples where both speeds agree
+public:
+    static double proximityToRange(int proximity);
+    static double getDriveClosingSpeed();
+    void reset();
+    void update();
+    double getRange() const;
+    double getClosingSpeed() const;
+    double getTimeToContact() const;
+    int getConfidence() const;
+    bool shouldFire() const;
+};
+
 class AutoClamp {
 private:
     static bool isActive;
@@ -14,6 +37,9 @@ private:
 public:
     static bool isDetected();
     static void waitUntilClamp(int maxDist, int maxTime);
+    // Fires the clamp ahead of contact, the drive has to already be reversing at speed
+    // Only testGoalSens uses it until goalSens has a real port, routes still creep onto goals
+    static void waitUntilClampPredictive(int maxDist, int maxTime);
     static bool isGoalClamped();
     static bool isEnabled();
     static void enable();
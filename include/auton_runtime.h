@@ -0,0 +1,230 @@
+#ifndef AUTON_RUNTIME_H
+#define AUTON_RUNTIME_H
+
+#include <coroutine>
+#include <cstddef>
+#include "pros/rtos.hpp"
+
+namespace RuntimeConfig {
+    /** @brief Maximum number of branches that can run at once. */
+    constexpr int MAX_BRANCHES = 16;
+
+    /** @brief Bytes reserved for each branch's coroutine frame. */
+    constexpr std::size_t FRAME_SIZE = 384;
+
+    /** @brief How often the runtime checks its branches, in milliseconds. */
+    extern const int TICK_RATE;
+}
+
+/**
+ * @class AutonTask
+ * @brief Return type of an autonomous coroutine.
+ *
+ * Any function returning AutonTask can use co_await to wait on timers, motions
+ * and sensors without blocking the task it runs on. Frames come from a fixed
+ * pool of RuntimeConfig::FRAME_SIZE blocks, so branches never touch the heap.
+ * If the pool is full or a frame is too large, the task is empty and never runs.
+ *
+ * @code {.cpp}
+ * AutonTask scoreStake() {
+ *     oc_motor.move(127);
+ *     co_await Await::time(500);
+ *     oc_motor.brake();
+ * }
+ * @endcode
+ */
+class AutonTask {
+public:
+    /**
+     * @brief Something a suspended branch is waiting on.
+     */
+    struct Waiter {
+        virtual bool ready() = 0;
+    };
+
+    struct promise_type {
+        Waiter* waiter = nullptr; ///< what the branch is waiting on, nullptr if it can run
+
+        static void* operator new(std::size_t size) noexcept;
+        static void operator delete(void* ptr) noexcept;
+        static AutonTask get_return_object_on_allocation_failure();
+
+        AutonTask get_return_object();
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception();
+    };
+
+    using Handle = std::coroutine_handle<promise_type>;
+
+    AutonTask(AutonTask&& other) noexcept;
+    AutonTask& operator=(AutonTask&& other) noexcept;
+    AutonTask(const AutonTask&) = delete;
+    AutonTask& operator=(const AutonTask&) = delete;
+    ~AutonTask();
+
+    /**
+     * @brief Give up ownership of the coroutine frame.
+     *
+     * @return the coroutine handle, empty if the frame could not be allocated
+     */
+    Handle release();
+
+private:
+    explicit AutonTask(Handle handle);
+
+    Handle handle;
+};
+
+/**
+ * @brief Base for everything a branch can co_await.
+ */
+struct AutonAwaiter : AutonTask::Waiter {
+    bool await_ready() { return ready(); }
+    void await_suspend(AutonTask::Handle handle) { handle.promise().waiter = this; }
+};
+
+/**
+ * @struct Branch
+ * @brief Identifies a branch started on the runtime.
+ */
+struct Branch {
+    int slot = -1;      ///< slot in the runtime, -1 if the branch never started
+    int generation = 0; ///< tells apart branches that reused the same slot
+};
+
+namespace Await {
+    struct TimeAwaiter : AutonAwaiter {
+        int wakeTime;
+        bool ready() override;
+        void await_resume() {}
+    };
+
+    struct UntilAwaiter : AutonAwaiter {
+        bool (*condition)();
+        int timeoutTime;
+        bool met = false;
+        bool ready() override;
+        bool await_resume() { return met; }
+    };
+
+    struct MotionAwaiter : AutonAwaiter {
+        bool ready() override;
+        void await_resume() {}
+    };
+
+    /**
+     * @brief Wait for a number of milliseconds.
+     */
+    TimeAwaiter time(int msec);
+
+    /**
+     * @brief Wait until a condition is true or it times out.
+     *
+     * @return true from co_await if the condition was met, false if it timed out
+     */
+    UntilAwaiter until(bool (*condition)(), int msecTimeout);
+
+    /**
+     * @brief Wait until the current chassis motion is done.
+     *
+     * Chassis motions queue behind each other and block until the last one ends,
+     * so await this before starting the next motion from a branch.
+     */
+    MotionAwaiter motion();
+}
+
+/**
+ * @class AutonRuntime
+ * @brief Runs autonomous coroutines side by side on a single task.
+ *
+ * Route code can spawn branches from the route task (for example to score with
+ * the arm while drivePID runs) or be written entirely as coroutines and run
+ * with run(). Branches are checked every RuntimeConfig::TICK_RATE ms. The
+ * runtime task is only created by the first spawn, so a program whose routes
+ * don't use branches doesn't pay for its ticks.
+ */
+class AutonRuntime {
+public:
+    struct JoinAwaiter : AutonAwaiter {
+        AutonRuntime* runtime;
+        Branch branch;
+        bool ready() override;
+        void await_resume() {}
+    };
+
+    /**
+     * @brief Start a branch on the runtime task, creating the task the first time.
+     *
+     * @param task the coroutine to run
+     * @return the branch, with a slot of -1 if there was no room
+     */
+    Branch spawn(AutonTask task);
+
+    /**
+     * @brief Start a coroutine and block the calling task until it is done.
+     *
+     * @param task the coroutine to run
+     */
+    void run(AutonTask task);
+
+    /**
+     * @brief Wait from inside a coroutine until another branch is done.
+     */
+    JoinAwaiter join(Branch branch);
+
+    /**
+     * @brief Check if a branch is done.
+     */
+    bool isDone(Branch branch);
+
+    /**
+     * @brief Block the calling task until a branch is done or it times out.
+     *
+     * @return true if the branch finished before the timeout
+     */
+    bool waitUntilDone(Branch branch, int msecTimeout);
+
+    /**
+     * @brief Stop a branch, destroying its frame where it is suspended.
+     */
+    void cancel(Branch branch);
+
+    /**
+     * @brief Stop every branch.
+     */
+    void cancelAll();
+
+    /**
+     * @brief Resume every branch that is ready, called by the runtime task.
+     */
+    void tick();
+
+    /**
+     * @brief Get the number of branches running.
+     */
+    int getBranchCount();
+
+private:
+    enum class SlotState {
+        EMPTY,   ///< slot is free
+        RUNNING, ///< branch is running
+        CANCELED ///< branch should be destroyed on the next tick
+    };
+
+    struct Slot {
+        AutonTask::Handle handle;
+        SlotState state = SlotState::EMPTY;
+        int generation = 0;
+    };
+
+    Slot slots[RuntimeConfig::MAX_BRANCHES];
+    pros::Mutex mutex;
+    pros::task_t runtimeTask = nullptr; // created by the first spawn
+};
+
+// Task that resumes autonomous coroutines
+void auton_runtime_task(void* param);
+
+#endif // AUTON_RUNTIME_H
@@ -13,6 +13,8 @@ class AutonSelector {
 private:
     std::vector<AutonRoutine> routines;
     int currentSelection;
+    std::function<void()> prewarmedRoutine; // selected routine with its parameter bound, ready to call
+    int prewarmedSelection = -1;            // selection prewarmedRoutine was made for
 
 public:
 
@@ -30,7 +32,8 @@ public:
     bool setSelection(int newSelection);
     void toggleDisplayTeam();
 
-    // Execution method
+    // Execution methods
+    void prewarm(); // look up the selected routine and stage the robot for it so auton starts without setup
     void runSelection();
 
     // Utility method
@@ -0,0 +1,73 @@
+#ifndef BATTERY_H
+#define BATTERY_H
+
+#include "pros/abstract_motor.hpp"
+#include "pros/rtos.hpp"
+
+namespace BatteryConfig {
+    /** @brief Battery voltage in mV that uncompensated commands were tuned at, compensated commands act like this. */
+    extern const double NOMINAL_VOLTAGE;
+
+    /** @brief Time between battery readings in ms. */
+    extern const int SAMPLE_RATE;
+
+    /** @brief EMA weight of each new reading, low enough to smooth out the noise from motor current spikes. */
+    extern const double FILTER_WEIGHT;
+
+    /** @brief Lowest reading in mV treated as real, anything lower is a failed read. */
+    extern const double MIN_VALID_VOLTAGE;
+}
+
+/**
+ * @class BatteryMonitor
+ * @brief Filters the battery voltage so open-loop commands can be scaled to match.
+ *
+ * Motors turn a command into a fraction of battery voltage, so the same command
+ * drives slower on a low battery. Compensated moves scale the command by
+ * nominal / measured voltage so timed moves cover the same distance at any charge.
+ */
+class BatteryMonitor {
+private:
+    pros::Mutex mutex;
+    double voltage = 0; // filtered voltage in mV, 0 until the first reading
+
+public:
+    /**
+     * @brief Take a battery reading and add it to the filter.
+     */
+    void update();
+
+    /**
+     * @brief Gets the filtered battery voltage.
+     * @return voltage in mV, or the nominal voltage before the first reading
+     */
+    double getVoltage();
+
+    /**
+     * @brief Gets how much open-loop commands are scaled up by.
+     * @return nominal voltage / filtered voltage
+     */
+    double getScale();
+
+    /**
+     * @brief Convert a move() power to a compensated voltage.
+     * @param power power out of 127, like pros::Motor::move
+     * @return voltage in mV, clamped to the motor's +-12000 mV range
+     */
+    int compensate(double power);
+
+    /**
+     * @brief Move a motor or motor group with a battery compensated power.
+     *
+     * Drop-in for move() on timed and open-loop moves.
+     *
+     * @param motor motor or motor group to move
+     * @param power power out of 127, like pros::Motor::move
+     */
+    void move(pros::AbstractMotor& motor, double power);
+};
+
+// Task that keeps the filtered battery voltage up to date
+void battery_task(void* param);
+
+#endif // BATTERY_H
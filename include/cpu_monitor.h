@@ -0,0 +1,108 @@
+#ifndef CPU_MONITOR_H
+#define CPU_MONITOR_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include "loop_timer.h"
+#include "pros/rtos.hpp"
+
+namespace CpuConfig {
+    /** @brief Number of windows kept, the long window covers all of them. */
+    constexpr int WINDOWS = 10;
+
+    /** @brief Length of one window in ms. */
+    extern const int SAMPLE_RATE;
+
+    /** @brief Percent of the CPU a loop can use over the long window before it gets a warning. */
+    extern const double LOOP_WARN;
+
+    /** @brief Time the idle probe spins before sleeping a tick in us. */
+    extern const int PROBE_SLICE;
+
+    /** @brief Gap between two of the probe's clock reads in us that means another task or an interrupt ran. */
+    extern const int PROBE_GAP;
+}
+
+/**
+ * @class CpuMonitor
+ * @brief Tracks how much of the CPU each timed loop and everything else uses over sliding windows.
+ *
+ * PROS's kernel doesn't expose FreeRTOS run time stats or task switch hooks,
+ * so per loop time comes from the LoopTimers: the time from each wake up to
+ * the next delay. That includes any time the loop was preempted, so it is an
+ * upper bound when the brain is busy.
+ *
+ * Total load comes from a probe task at the lowest priority that spins reading
+ * the clock. It only runs when nothing else wants the CPU, so every gap between
+ * its reads is time something else ran, including lemlib's tasks, PROS's
+ * daemons and interrupts. Whatever the loops don't account for is "other".
+ * tools/cpu_sched_sim runs the same accounting against a simulated scheduler.
+ */
+class CpuMonitor {
+private:
+    pros::Mutex mutex;
+    std::uint32_t lastRunTime[LoopTimerConfig::MAX_TIMERS] = {};
+    std::uint32_t loopRun[LoopTimerConfig::MAX_TIMERS][CpuConfig::WINDOWS] = {}; // us run in each window
+    double peak[LoopTimerConfig::MAX_TIMERS] = {};                              // highest percent in one window
+    bool warned[LoopTimerConfig::MAX_TIMERS] = {};
+    std::uint32_t windowLength[CpuConfig::WINDOWS] = {}; // us
+    std::uint32_t windowBusy[CpuConfig::WINDOWS] = {};   // us the probe saw taken by others
+    std::uint32_t windowSeen[CpuConfig::WINDOWS] = {};   // us the probe was watching
+    int head = 0;    // window being filled next
+    int filled = 0;  // windows with data, up to WINDOWS
+    int loops = 0;   // timers seen so far
+    std::uint32_t lastSample = 0;
+    std::uint32_t lastBusy = 0;
+    std::uint32_t lastSeen = 0;
+
+    // written by the probe task only
+    std::atomic<std::uint32_t> probeBusy = 0;
+    std::atomic<std::uint32_t> probeSeen = 0;
+
+    double share(const std::uint32_t* run, int windows) const;
+    double totalShare(int windows) const;
+
+public:
+    /**
+     * @brief Close the current window, call every CpuConfig::SAMPLE_RATE ms.
+     */
+    void update();
+
+    /**
+     * @brief Spin at the lowest priority measuring idle time, never returns.
+     */
+    void runProbe();
+
+    /**
+     * @brief Gets the percent of the CPU a loop used.
+     * @param name name the loop's timer was made with
+     * @param windows how many of the latest windows to average, 1 for the last second
+     * @return percent from 0 to 100, -1 if there is no such loop or no data yet
+     */
+    double getLoopLoad(const char* name, int windows = CpuConfig::WINDOWS);
+
+    /**
+     * @brief Gets the percent of the CPU used by everything but the probe and the idle task.
+     * @return percent from 0 to 100, -1 if there is no data yet
+     */
+    double getTotalLoad(int windows = CpuConfig::WINDOWS);
+
+    /**
+     * @brief Print total load, the busiest loop and what the loops don't account for on one LCD line.
+     */
+    void printTelemetry(int line);
+
+    /**
+     * @brief Print every loop's load over the last window and the long window.
+     */
+    void printReport(FILE* out = stdout);
+};
+
+// Task that closes a CPU load window every second
+void cpu_monitor_task(void* param);
+
+// Task that measures idle time, start it at TASK_PRIORITY_MIN
+void cpu_probe_task(void* param);
+
+#endif // CPU_MONITOR_H
@@ -0,0 +1,142 @@
+#ifndef DEVICE_CACHE_H
+#define DEVICE_CACHE_H
+
+#include <atomic>
+#include <cstdint>
+#include "pros/abstract_motor.hpp"
+#include "pros/adi.hpp"
+#include "pros/rtos.hpp"
+
+namespace DeviceCacheConfig {
+    /** @brief Number of smart ports on the brain. */
+    constexpr int PORTS = 21;
+
+    /** @brief Time in ms after which an unchanged command is sent again anyway, in case something bypassed the cache. */
+    extern const int REFRESH_TIME;
+
+    /** @brief Time in ms between a motor's command updates, a different command sooner than this overwrites one the motor may never have seen. */
+    extern const int CYCLE_TIME;
+}
+
+/**
+ * @class DeviceCache
+ * @brief Remembers the last command sent to each port and drops writes that wouldn't change anything.
+ *
+ * Commands are kept per smart port, so groups that share motors, like
+ * all_motors and left_motors, dedupe against each other. Brake modes are
+ * cached on every port since nothing else sets them. Movement commands are
+ * only cached on motors marked with own(), because lemlib drives the
+ * drivetrain directly and the cache can't see those writes. Every write to an
+ * owned motor has to go through the cache, including IntakeController's and
+ * battery_monitor's, and the actuator scheduler only reaches motors through
+ * actions that call those. A repeated command is still checked against the
+ * voltage the motor reports, so a write that slipped past the cache is
+ * noticed and the command resent, and anything else is resent after
+ * REFRESH_TIME so a reconnected motor can't stay on a stale command for long.
+ *
+ * The brain sends each motor only its latest command every device cycle, so
+ * several writes to a port within one cycle already reach the motor as one.
+ * Those are counted as overwritten rather than held back and merged, since
+ * holding a write would delay commands issued before a wait in the same cycle.
+ */
+class DeviceCache {
+private:
+    enum class Command : std::uint8_t {
+        UNKNOWN,
+        MOVE,
+        VOLTAGE,
+        VELOCITY,
+        BRAKE
+    };
+
+    struct PortState {
+        bool owned = false;
+        Command command = Command::UNKNOWN;
+        std::int32_t value = 0;
+        std::uint32_t commandTime = 0; // when the command was last sent in ms
+        std::int32_t brakeMode = -1;   // -1 until a brake mode is set through the cache
+        std::uint32_t brakeModeTime = 0;
+    };
+
+    pros::Mutex mutex;
+    PortState ports[DeviceCacheConfig::PORTS];
+    std::atomic<int> sent = 0;
+    std::atomic<int> suppressed = 0;
+    std::atomic<int> overwritten = 0;
+    std::atomic<int> resynced = 0;
+
+    static int indexOf(std::int8_t port);
+    static bool motorAgrees(pros::AbstractMotor& motor, int index, const PortState& state);
+    void command(pros::AbstractMotor& motor, Command command, std::int32_t value);
+
+public:
+    /**
+     * @brief Mark every motor of a motor or group as only moved through the cache, so its moves can be deduped.
+     */
+    void own(pros::AbstractMotor& motor);
+
+    /**
+     * @brief Move like pros::Motor::move.
+     * @param power power out of 127
+     */
+    void move(pros::AbstractMotor& motor, std::int32_t power);
+
+    /**
+     * @brief Move like pros::Motor::move_voltage.
+     * @param voltage voltage in mV
+     */
+    void moveVoltage(pros::AbstractMotor& motor, std::int32_t voltage);
+
+    /**
+     * @brief Move like pros::Motor::move_velocity.
+     * @param velocity velocity in the gearset's rpm
+     */
+    void moveVelocity(pros::AbstractMotor& motor, std::int32_t velocity);
+
+    /**
+     * @brief Stop like pros::Motor::brake, with the motor's brake mode.
+     */
+    void brake(pros::AbstractMotor& motor);
+
+    /**
+     * @brief Set the brake mode of every motor in a motor or group, only writing the motors that differ.
+     */
+    void setBrakeMode(pros::AbstractMotor& motor, pros::motor_brake_mode_e_t mode);
+
+    /**
+     * @brief Extend or retract a piston if it isn't already.
+     */
+    void setPiston(pros::adi::Pneumatics& piston, bool extended);
+
+    /**
+     * @brief Forget every cached command, the next write to each port is sent.
+     */
+    void invalidate();
+
+    /**
+     * @brief Gets how many writes were sent to devices.
+     */
+    int getSent();
+
+    /**
+     * @brief Gets how many writes were dropped because the device already had that command.
+     */
+    int getSuppressed();
+
+    /**
+     * @brief Gets how many writes replaced a different command sent less than a device cycle before.
+     */
+    int getOverwritten();
+
+    /**
+     * @brief Gets how many repeated writes were sent anyway because the motor wasn't doing what the cache remembered.
+     */
+    int getResynced();
+
+    /**
+     * @brief Print the write counts to the terminal.
+     */
+    void printReport();
+};
+
+#endif // DEVICE_CACHE_H
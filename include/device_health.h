@@ -0,0 +1,116 @@
+#ifndef DEVICE_HEALTH_H
+#define DEVICE_HEALTH_H
+
+#include <cstdint>
+#include "pros/abstract_motor.hpp"
+#include "pros/device.hpp"
+#include "pros/rtos.hpp"
+
+namespace HealthConfig {
+    /** @brief Most devices that can be registered. */
+    constexpr int MAX_DEVICES = 16;
+
+    /** @brief Time between checks of every device in ms. */
+    extern const int UPDATE_RATE;
+
+    /** @brief Time in ms without a good reading before a device counts as stale. */
+    extern const int STALE_TIME;
+
+    /** @brief EMA weight of each read in the error rate. */
+    extern const double ERROR_WEIGHT;
+
+    /** @brief Fraction of failed reads above which a device counts as faulted. */
+    extern const double MAX_ERROR_RATE;
+}
+
+/**
+ * @enum DeviceFault
+ * @brief What is wrong with a device, OK if nothing.
+ */
+enum class DeviceFault {
+    OK,
+    BAD_PORT,       ///< port isn't 1-21, the device can never work
+    SHARED_PORT,    ///< another device was registered on the same port
+    WRONG_DEVICE,   ///< something other than the expected device is plugged in
+    DISCONNECTED,   ///< nothing is plugged in
+    STALE,          ///< no good reading for STALE_TIME
+    ERRORS          ///< too many reads are failing
+};
+
+/**
+ * @class DeviceHealth
+ * @brief Checks every smart port device at startup and while running so features can stop trusting broken ones.
+ *
+ * validate() catches wiring and config mistakes before the match: ports out of
+ * range, two devices on one port and the wrong device plugged in. update()
+ * then reads each device every cycle and tracks its failed read rate and last
+ * good reading, so an unplugged or flaky device is faulted and warned about
+ * on the brain screen within a cycle. Features that depend on a device check
+ * isHealthy() with its port and turn themselves off instead of acting on
+ * PROS_ERR readings.
+ */
+class DeviceHealth {
+private:
+    struct Entry {
+        const char* name;
+        std::uint8_t port;
+        pros::DeviceType type;
+        DeviceFault configFault = DeviceFault::OK; // found by validate, never clears
+        DeviceFault fault = DeviceFault::OK;
+        double errorRate = 0;
+        int lastGood = 0; // time of the last good read in ms
+    };
+
+    pros::Mutex mutex;
+    Entry entries[HealthConfig::MAX_DEVICES];
+    int count = 0;
+
+    static bool read(const Entry& entry);
+    static const char* faultName(DeviceFault fault);
+
+public:
+    /**
+     * @brief Register a device to be checked.
+     * @param name name shown in warnings
+     * @param port smart port the device was constructed with
+     * @param type the kind of device that should be on the port
+     */
+    void add(const char* name, std::uint8_t port, pros::DeviceType type);
+
+    /**
+     * @brief Register every motor in a motor or group under one name.
+     */
+    void add(const char* name, pros::AbstractMotor& motor);
+
+    /**
+     * @brief Check every registered device's port and what is plugged into it, warning about each problem.
+     * @return true if every device is fine
+     */
+    bool validate();
+
+    /**
+     * @brief Read every device once and update its fault.
+     */
+    void update();
+
+    /**
+     * @brief Whether every device registered on a port is working.
+     * @return false for ports nothing valid was registered on, like 0
+     */
+    bool isHealthy(std::uint8_t port);
+
+    /**
+     * @brief Gets the fault of the device on a port.
+     */
+    DeviceFault getFault(std::uint8_t port);
+
+    /**
+     * @brief Print every device's fault, error rate and time since its last good reading to the terminal.
+     */
+    void printReport();
+};
+
+// Task that checks every device every cycle
+void device_health_task(void* param);
+
+#endif // DEVICE_HEALTH_H
@@ -0,0 +1,126 @@
+#ifndef DEVICE_TIMING_H
+#define DEVICE_TIMING_H
+
+#include <cstdint>
+#include "pros/rtos.hpp"
+
+namespace TimingConfig {
+    /** @brief Time in ms between new readings from motors, and from optical sensors at 10 ms integration. */
+    constexpr int DEVICE_PERIOD = 10;
+
+    /** @brief Time in ms spent watching for new readings at startup to learn their phase. */
+    extern const int LEARN_TIME;
+
+    /** @brief Fewest new readings a source needs while learning for its phase to be trusted. */
+    extern const int MIN_UPDATES;
+
+    /** @brief Fraction of new readings that have to land on the most common ms for the phase to be trusted. */
+    extern const double MIN_AGREEMENT;
+
+    /** @brief Ticks after the tick a new reading is first seen that aligned loops wake. */
+    extern const int WAKE_OFFSET;
+
+    /** @brief Time in ms between checks that the learned phases still hold. */
+    extern const int CHECK_RATE;
+
+    /** @brief Average age in us of a motor reading seen by aligned loops above which the phase is learned again. */
+    extern const int MAX_AGE;
+
+    /** @brief EMA weight of each measured age. */
+    extern const double AGE_WEIGHT;
+
+    /** @brief Time in ms after which every phase is learned again anyway, the ring sensor's age can't be measured. */
+    extern const int RELEARN_TIME;
+}
+
+/**
+ * @enum DataSource
+ * @brief Devices whose readings control loops are aligned to.
+ */
+enum class DataSource {
+    DRIVE,       ///< first left drive motor, all six report together
+    INTAKE,      ///< intake motor
+    RING_SENSOR, ///< optical sensor at the top of the intake
+    COUNT
+};
+
+/**
+ * @class DeviceTiming
+ * @brief Learns when each device delivers new readings and wakes loops right after.
+ *
+ * Devices report on their own fixed cycle, so a loop that wakes at an arbitrary
+ * phase acts on a reading up to a full period old. learn() polls every source
+ * each tick for LEARN_TIME and notes the tick each new reading first shows up:
+ * motors stamp every reading, the optical sensor's raw channels change with
+ * every integration. The most common tick modulo the period is the phase.
+ *
+ * Aligned loops then sleep until the phase instead of for a fixed time, and
+ * getAge() reports how old a source's latest reading is so loops can record
+ * the age of the data each decision used. Motor ages are measured from the
+ * timestamp the motor sends with each reading, so they show drift or a
+ * wrongly learned phase. When the average measured age passes MAX_AGE the
+ * phases are learned again, and every RELEARN_TIME regardless for the ring
+ * sensor, whose age can only be estimated from its phase. Sources whose phase
+ * couldn't be learned, like a sensor that isn't plugged in, fall back to
+ * plain periods.
+ */
+class DeviceTiming {
+private:
+    pros::Mutex mutex;
+    int phases[static_cast<int>(DataSource::COUNT)]; // ms within the period, -1 until learned
+    double ages[static_cast<int>(DataSource::COUNT)] = {}; // average measured age in us since the last learn
+    bool learned = false;
+    std::uint32_t learnTime = 0; // when the phases were last learned in ms
+
+public:
+    DeviceTiming();
+
+    /**
+     * @brief Watch every source for TimingConfig::LEARN_TIME and work out its phase, blocks until done.
+     */
+    void learn();
+
+    /**
+     * @brief Gets the tick within the period a source's new readings are first seen on.
+     * @return ms from 0 to DEVICE_PERIOD - 1, or -1 if it hasn't been learned
+     */
+    int getPhase(DataSource source);
+
+    /**
+     * @brief Gets how long ago the source's latest reading arrived.
+     *
+     * Motor ages come from the reading's timestamp and feed the drift check,
+     * the ring sensor's is estimated from its phase.
+     *
+     * @param aligned whether the calling loop wakes on this source's phase, only those ages feed the drift check
+     * @return age in us, 0 if it can't be measured and the phase hasn't been learned
+     */
+    std::uint32_t getAge(DataSource source, bool aligned = true);
+
+    /**
+     * @brief Whether the phases should be learned again, because a measured age drifted or they are old.
+     */
+    bool needsRelearn();
+
+    /**
+     * @brief Gets when a periodic loop aligned to a source should wake next.
+     *
+     * The wake up is the aligned tick nearest one period after the last, so
+     * the loop keeps its rate while moving onto the source's phase.
+     *
+     * @param lastWake the time the loop last woke in ms
+     * @param period the loop's period in ms
+     * @return time to wake in ms, always in the future
+     */
+    std::uint32_t nextWake(DataSource source, std::uint32_t lastWake, int period);
+
+    /**
+     * @brief Print every source's phase to the terminal.
+     */
+    void printReport();
+};
+
+// Task that learns the device phases at startup and again when they drift
+void device_timing_task(void* param);
+
+#endif // DEVICE_TIMING_H
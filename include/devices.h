@@ -8,6 +8,24 @@
 #include "color_sort.h"
 #include "auto_clamp.h"
 #include "lemlib/chassis/chassis.hpp"
+#include "trigger_chassis.h"
+#include "auton_runtime.h"
+#include "actuator_scheduler.h"
+#include "geofence.h"
+#include "battery.h"
+#include "thermal.h"
+#include "power.h"
+#include "intake_controller.h"
+#include "ring_tracker.h"
+#include "ring_classifier.h"
+#include "resource_monitor.h"
+#include "alloc_tracker.h"
+#include "loop_timer.h"
+#include "cpu_monitor.h"
+#include "device_cache.h"
+#include "device_timing.h"
+#include "device_health.h"
+#include "trace.h"
 
 // namespace for declarations
 using namespace pros;
@@ -41,8 +59,26 @@ extern OdomSensors sensors;
 extern ControllerSettings lateral_controller;
 extern ControllerSettings angular_controller;
 extern ExpoDriveCurve throttle_curve;
-extern Chassis chassis;
+extern TriggerChassis chassis;
 extern ColorSort color_sort;
 extern AutoClamp auto_clamp;
+extern AutonRuntime auton_runtime;
+extern ActuatorScheduler actuator_scheduler;
+extern Geofence geofence;
+extern BatteryMonitor battery_monitor;
+extern ThermalMonitor thermal_monitor;
+extern PowerManager power_manager;
+extern IntakeController intake_controller;
+extern RingTracker ring_tracker;
+extern RingClassifier ring_classifier;
+extern ResourceMonitor resource_monitor;
+extern AllocTracker alloc_tracker;
+extern CpuMonitor cpu_monitor;
+extern DeviceCache device_cache;
+extern DeviceTiming device_timing;
+extern DeviceHealth device_health;
+#if TRACE_ENABLED
+extern Tracer tracer;
+#endif
 
 #endif // DEVICES_H
\ No newline at end of file
@@ -0,0 +1,127 @@
+#ifndef GEOFENCE_H
+#define GEOFENCE_H
+
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include "lemlib/pose.hpp"
+#include "pros/rtos.hpp"
+
+namespace GeofenceConfig {
+    /** @brief Maximum number of zones, one bit each in the grid cells. */
+    constexpr int MAX_ZONES = 32;
+
+    /** @brief Maximum number of corners in a polygon zone. */
+    constexpr int MAX_VERTICES = 8;
+
+    /** @brief Number of grid cells along each side of the field. */
+    constexpr int GRID_CELLS = 12;
+
+    /** @brief Length of a side of the field in inches, centered on (0, 0). */
+    extern const float FIELD_SIZE;
+
+    /** @brief How often the geofence task checks the robot pose, in milliseconds. */
+    extern const int UPDATE_RATE;
+}
+
+/**
+ * @class Geofence
+ * @brief Fires actions when the robot enters or leaves zones on the field.
+ *
+ * Zones are circles or polygons in field coordinates. Each one is marked in
+ * every grid cell its bounding box touches, so an update only tests the zones
+ * in the robot's cell plus the zones it is already inside, no matter how many
+ * zones are registered.
+ *
+ * @code {.cpp}
+ * geofence.addCircle(-47, 0, 6, []() { redirect.extend(); }, nullptr, true);
+ * @endcode
+ *
+ * @note Actions run on the geofence task, so they should be quick (pistons, motor commands).
+ */
+class Geofence {
+public:
+    /**
+     * @brief Add a circular zone.
+     *
+     * @param x x position of the center in inches
+     * @param y y position of the center in inches
+     * @param radius radius in inches
+     * @param onEnter action when the robot enters the zone, can be nullptr
+     * @param onExit action when the robot leaves the zone, can be nullptr
+     * @param once remove the zone after the robot enters it the first time
+     * @return id of the zone, or -1 if there was no room
+     */
+    int addCircle(float x, float y, float radius, std::function<void()> onEnter,
+                  std::function<void()> onExit = nullptr, bool once = false);
+
+    /**
+     * @brief Add a polygon zone.
+     *
+     * @param vertices corners of the polygon in order, theta is ignored
+     * @param onEnter action when the robot enters the zone, can be nullptr
+     * @param onExit action when the robot leaves the zone, can be nullptr
+     * @param once remove the zone after the robot enters it the first time
+     * @return id of the zone, or -1 if there was no room or too many corners
+     */
+    int addPolygon(std::initializer_list<lemlib::Pose> vertices, std::function<void()> onEnter,
+                   std::function<void()> onExit = nullptr, bool once = false);
+
+    /**
+     * @brief Remove a zone without firing its exit action.
+     */
+    void remove(int id);
+
+    /**
+     * @brief Remove every zone.
+     */
+    void clear();
+
+    /**
+     * @brief Check if the robot was inside a zone at the last update.
+     */
+    bool isInside(int id);
+
+    /**
+     * @brief Check the zones against a pose and fire actions, called by the geofence task.
+     */
+    void update(lemlib::Pose pose);
+
+private:
+    enum class ZoneShape {
+        CIRCLE,
+        POLYGON
+    };
+
+    enum class ZoneState {
+        EMPTY,  ///< slot is free
+        ACTIVE, ///< zone is being checked
+        REMOVED ///< zone will be cleared on the next update
+    };
+
+    struct Zone {
+        ZoneShape shape;
+        ZoneState state = ZoneState::EMPTY;
+        float x[GeofenceConfig::MAX_VERTICES]; ///< center for circles, corners for polygons
+        float y[GeofenceConfig::MAX_VERTICES];
+        int vertexCount;
+        float radius;
+        bool once;
+        std::function<void()> onEnter;
+        std::function<void()> onExit;
+    };
+
+    int addZone(Zone zone, float minX, float minY, float maxX, float maxY);
+    bool contains(const Zone& zone, float x, float y) const;
+    int cellIndex(float coord) const;
+
+    Zone zones[GeofenceConfig::MAX_ZONES];
+    std::uint32_t grid[GeofenceConfig::GRID_CELLS][GeofenceConfig::GRID_CELLS] = {};
+    std::uint32_t insideMask = 0; ///< zones the robot was inside at the last update
+    pros::Mutex mutex;
+};
+
+// Task that checks the robot pose against the geofence zones
+void geofence_task(void* param);
+
+#endif // GEOFENCE_H
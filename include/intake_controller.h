@@ -0,0 +1,119 @@
+#ifndef INTAKE_CONTROLLER_H
+#define INTAKE_CONTROLLER_H
+
+#include "pros/rtos.hpp"
+
+namespace IntakeConfig {
+    /** @brief Speed in rpm below which a powered intake might be stalled. */
+    extern const double STALL_VELOCITY;
+
+    /** @brief Fraction of the intake's current allocation above which a slow intake is stalled rather than just starting. */
+    extern const double STALL_CURRENT;
+
+    /** @brief Torque in Nm above which a slow intake is stalled. */
+    extern const double STALL_TORQUE;
+
+    /** @brief Time in ms the intake has to stay stalled before it counts as a jam. */
+    extern const int STALL_TIME;
+
+    /** @brief Time in ms after the intake starts where stalls are ignored, spinning up looks like a stall. */
+    extern const int SPINUP_TIME;
+
+    /** @brief Power out of 127 the intake reverses at to clear a jam. */
+    extern const int UNJAM_POWER;
+
+    /** @brief Time in ms the intake reverses for. */
+    extern const int REVERSE_TIME;
+
+    /** @brief Jams in a row, each within RETRY_WINDOW of the last, before the intake gives up and stops. */
+    extern const int MAX_RETRIES;
+
+    /** @brief Time in ms after an unjam where another jam counts as the same one coming back. */
+    extern const int RETRY_WINDOW;
+
+    /** @brief Time between checks in ms. */
+    extern const int UPDATE_RATE;
+}
+
+/**
+ * @class IntakeController
+ * @brief Runs the intake and clears jams on its own.
+ *
+ * A jam is the intake turning slower than STALL_VELOCITY while drawing near
+ * its current allocation from power_manager, or high torque, for STALL_TIME. The intake then reverses for REVERSE_TIME
+ * and goes back to the power it was asked for. If the same jam keeps coming
+ * back the intake stops so it doesn't cook the motor.
+ *
+ * Only moves sent through this class are known to it, commands sent straight
+ * to the intake motor bypass jam handling. A repeated move doesn't restart the
+ * spin up, but still resends the power so a write that bypassed this class
+ * can't leave the intake stopped while it thinks it is running.
+ */
+class IntakeController {
+private:
+    enum class State {
+        IDLE,      // braked
+        RUNNING,   // running at the requested power
+        REVERSING, // clearing a jam
+        GAVE_UP    // stopped after the jam kept coming back
+    };
+
+    pros::Mutex mutex;
+    State state = State::IDLE;
+    double power = 0;      // requested power out of 127
+    bool compensated = true; // whether power is battery compensated, driver control isn't
+    int stateStart = 0;    // time the current state started
+    int spinupEnd = 0;     // time stalls start counting again after a start
+    int stallStart = -1;   // time the current stall started, -1 if not stalled
+    int jamStart = 0;      // time the jam being cleared was first seen
+    int lastUnjam = 0;     // time the last unjam finished
+    int retries = 0;       // jams in a row within the retry window
+    int jamCount = 0;
+    int lostTime = 0;      // ms spent jammed or clearing jams
+
+    void send(double sendPower);
+
+public:
+    /**
+     * @brief Run the intake with jam handling.
+     * @param newPower power out of 127, 0 brakes
+     * @param compensate whether to battery compensate the power, driver control sends it as is
+     */
+    void move(double newPower, bool compensate = true);
+
+    /**
+     * @brief Stop the intake.
+     */
+    void brake();
+
+    /**
+     * @brief Check for a jam and step the unjam sequence.
+     */
+    void update();
+
+    /**
+     * @brief Whether the intake stopped itself because a jam wouldn't clear.
+     */
+    bool isStuck();
+
+    /**
+     * @brief Gets how many jams were seen since the stats were reset.
+     */
+    int getJamCount();
+
+    /**
+     * @brief Gets how long the intake spent jammed or clearing jams since the stats were reset.
+     * @return ms
+     */
+    int getLostTime();
+
+    /**
+     * @brief Reset the jam count and lost time.
+     */
+    void resetStats();
+};
+
+// Task that watches the intake for jams and clears them
+void intake_control_task(void* param);
+
+#endif // INTAKE_CONTROLLER_H
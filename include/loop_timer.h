@@ -0,0 +1,165 @@
+#ifndef LOOP_TIMER_H
+#define LOOP_TIMER_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+
+namespace LoopTimerConfig {
+    /** @brief Bits of linear sub-buckets in each power of two, 3 keeps every bucket within 12.5%. */
+    constexpr int SUB_BUCKET_BITS = 3;
+
+    /** @brief Highest power of two recorded in microseconds, anything longer lands in the last bucket. */
+    constexpr int MAX_BITS = 20;
+
+    /** @brief Number of buckets in a histogram. */
+    constexpr int BUCKETS = (MAX_BITS - SUB_BUCKET_BITS + 1) << SUB_BUCKET_BITS;
+
+    /** @brief Most loop timers that can be registered for dumps. */
+    constexpr int MAX_TIMERS = 24;
+
+    /** @brief File on the SD card dumps are appended to. */
+    extern const char* DUMP_FILE;
+}
+
+/**
+ * @class LatencyHistogram
+ * @brief Fixed size log-linear histogram of microsecond durations.
+ *
+ * Buckets are exact below 2^SUB_BUCKET_BITS us, then each power of two is
+ * split into 2^SUB_BUCKET_BITS equal buckets, so the error of any percentile
+ * is bounded by the bucket width rather than growing with the value. Recording
+ * is a count leading zeros, a shift and an increment.
+ */
+class LatencyHistogram {
+private:
+    std::uint32_t counts[LoopTimerConfig::BUCKETS] = {};
+    std::uint32_t total = 0;
+    std::uint32_t max = 0;
+
+    static int bucketOf(std::uint32_t micros);
+    static std::uint32_t bucketTop(int bucket);
+
+public:
+    /**
+     * @brief Add one duration.
+     */
+    void record(std::uint32_t micros);
+
+    /**
+     * @brief Gets a percentile.
+     * @param fraction from 0 to 1, 0.99 for p99
+     * @return upper edge of the bucket the percentile falls in, in us
+     */
+    std::uint32_t percentile(double fraction) const;
+
+    /**
+     * @brief Gets the longest duration recorded in us.
+     */
+    std::uint32_t getMax() const;
+
+    /**
+     * @brief Gets how many durations have been recorded.
+     */
+    std::uint32_t getCount() const;
+
+    /**
+     * @brief Forget everything recorded.
+     */
+    void reset();
+};
+
+/**
+ * @class LoopTimer
+ * @brief Measures how late a periodic loop wakes up, how long each cycle runs and how old its readings were.
+ *
+ * Replace the loop's pros::delay with the timer's delay. Only the loop's own
+ * task writes to it, so recording takes no lock, and a dump running at the
+ * same time can at worst be a sample behind.
+ *
+ * @code {.cpp}
+ * LoopTimer colorSortTimer("Color Sort", 20);
+ * while (true) {
+ *     ...
+ *     colorSortTimer.delay();
+ * }
+ * @endcode
+ *
+ * @note Timers register themselves for dumps, so they must live as long as the program (globals).
+ */
+class LoopTimer {
+private:
+    const char* name;
+    int period; // ms
+    std::uint64_t wakeTime = 0; // us, 0 until the first delay
+    LatencyHistogram lateness;
+    LatencyHistogram execution;
+    LatencyHistogram age; // age of the readings each cycle acted on
+    std::atomic<std::uint32_t> runTime = 0; // us of execution since startup, wraps after about 71 minutes
+
+    void recordExecution(std::uint64_t sleepTime);
+
+public:
+    LoopTimer(const char* name, int period);
+
+    /**
+     * @brief Record the cycle's execution time, sleep for the period and record how late the wake up was.
+     */
+    void delay();
+
+    /**
+     * @brief Like delay(), but sleep until a time instead of for the period.
+     * @param wake time to wake in ms, usually from DeviceTiming::nextWake
+     */
+    void delayUntil(std::uint32_t wake);
+
+    /**
+     * @brief Record how old the readings this cycle acted on were.
+     * @param micros age in us, usually from DeviceTiming::getAge
+     */
+    void recordAge(std::uint32_t micros);
+
+    /**
+     * @brief Gets the name the timer was made with.
+     */
+    const char* getName() const;
+
+    /**
+     * @brief Gets the total execution time so far in us, take differences to get the time in a window.
+     */
+    std::uint32_t getRunTime() const;
+
+    /**
+     * @brief Print the timer's percentiles as one row.
+     */
+    void print(FILE* out) const;
+
+    /**
+     * @brief Forget everything recorded.
+     */
+    void reset();
+};
+
+/**
+ * @brief Gets how many loop timers are registered.
+ */
+int getLoopTimerCount();
+
+/**
+ * @brief Gets a registered loop timer.
+ * @param index from 0 to getLoopTimerCount() - 1, in the order they were constructed
+ */
+LoopTimer* getLoopTimer(int index);
+
+/**
+ * @brief Print every loop timer's wake up lateness, execution time and reading age percentiles.
+ */
+void dumpLoopTimers(FILE* out);
+
+/**
+ * @brief Append every loop timer's percentiles to the dump file on the SD card.
+ * @return true if they were written
+ */
+bool dumpLoopTimersToSd();
+
+#endif // LOOP_TIMER_H
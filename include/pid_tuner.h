@@ -0,0 +1,75 @@
+#ifndef PID_TUNER_H
+#define PID_TUNER_H
+
+#include "lemlib/chassis/chassis.hpp"
+
+namespace TunerConfig {
+    /** @brief File on the SD card the tuned controller settings are saved to. */
+    extern const char* SETTINGS_FILE;
+
+    /** @brief Motor output of the relay experiment, out of 127. */
+    extern const int RELAY_OUTPUT;
+
+    /** @brief Number of relay oscillations measured after the first ones settle. */
+    extern const int RELAY_CYCLES;
+}
+
+/**
+ * @struct RelayResult
+ * @brief What a relay experiment measured about the drivetrain.
+ */
+struct RelayResult {
+    double ultimateGain;   ///< proportional gain that would make the drivetrain oscillate, in lemlib units
+    double ultimatePeriod; ///< period of that oscillation in seconds
+    double noise;          ///< standard deviation of the error while holding still
+    bool valid;            ///< false if the drivetrain never settled into an oscillation
+};
+
+/**
+ * @brief Run a relay experiment around the current pose.
+ *
+ * Bangs the drivetrain back and forth across the starting position (or heading
+ * if angular) and measures the oscillation it settles into.
+ *
+ * @param angular true to turn in place, false to drive forward and back
+ */
+RelayResult runRelayExperiment(bool angular);
+
+/**
+ * @brief Tune the lateral controller on the robot.
+ *
+ * Runs a relay experiment, a full power step to measure acceleration for the
+ * slew, then step trials of a few candidate gains and keeps the one that
+ * settles fastest. Needs about 3 feet of clear space in front of the robot.
+ *
+ * @return the tuned settings, or the current settings if tuning failed
+ */
+lemlib::ControllerSettings autotuneLateral();
+
+/**
+ * @brief Tune the angular controller on the robot.
+ *
+ * Same as autotuneLateral but turning in place.
+ *
+ * @return the tuned settings, or the current settings if tuning failed
+ */
+lemlib::ControllerSettings autotuneAngular();
+
+/**
+ * @brief Save the chassis controller settings to the SD card.
+ *
+ * @return true if the settings were saved
+ */
+bool saveControllerSettings();
+
+/**
+ * @brief Load controller settings from the SD card and apply them to the chassis.
+ *
+ * @return true if settings were found and applied
+ */
+bool loadControllerSettings();
+
+// Tunes both controllers, applies them and saves them to the SD card
+void autotunePID(int i);
+
+#endif // PID_TUNER_H
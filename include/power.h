@@ -0,0 +1,126 @@
+#ifndef POWER_H
+#define POWER_H
+
+#include "pros/rtos.hpp"
+
+namespace PowerConfig {
+    /** @brief Current the brain can share between all motors in mA. */
+    extern const int TOTAL_BUDGET;
+
+    /** @brief Highest current limit a motor can be given in mA, the 11W motor's own limit. */
+    extern const int MAX_LIMIT;
+
+    /** @brief Current limit every motor keeps in mA so an idle one can still start moving. */
+    extern const int MIN_LIMIT;
+
+    /** @brief Current per motor in mA above which a subsystem is treated as working. */
+    extern const int ACTIVE_CURRENT;
+
+    /** @brief Time in ms a commanded subsystem counts as working before its draw shows it. */
+    extern const int COMMAND_HOLD;
+
+    /** @brief Smallest change in a limit in mA worth sending to the motors. */
+    extern const int LIMIT_DEADBAND;
+
+    /** @brief Time between allocations in ms. */
+    extern const int UPDATE_RATE;
+}
+
+/**
+ * @enum PowerSubsystem
+ * @brief Groups of motors that share a current allocation.
+ */
+enum class PowerSubsystem {
+    DRIVE,  ///< all six drive motors
+    INTAKE, ///< intake motor
+    OC,     ///< oc arm motor
+    COUNT
+};
+
+/**
+ * @enum PowerMode
+ * @brief Which subsystem gets first claim on the current budget.
+ */
+enum class PowerMode {
+    BALANCED,       ///< drive, then intake, then oc
+    DRIVE_PRIORITY, ///< drive at its max with the intake held to its minimum, for rushes
+    SCORING         ///< oc arm at its max, then intake, then drive
+};
+
+/**
+ * @class PowerManager
+ * @brief Splits the brain's current budget between subsystems by priority.
+ *
+ * Every update each subsystem gets its minimum, then the rest of the budget
+ * goes to working subsystems in the mode's priority order, and what is left
+ * to idle ones so they can start without waiting an update. A subsystem
+ * counts as working once its draw shows it or for COMMAND_HOLD after
+ * command(). In DRIVE_PRIORITY and SCORING the first subsystem always gets
+ * MAX_LIMIT, even past the budget, so a priority mode is never slower than
+ * the firmware's own limit, and setMode() sends it right away. Limits are
+ * set through set_current_limit so the split is decided here instead of by
+ * the firmware cutting whichever motor asks last.
+ */
+class PowerManager {
+private:
+    pros::Mutex mutex;
+    PowerMode mode = PowerMode::BALANCED;
+    int allocations[static_cast<int>(PowerSubsystem::COUNT)] = {}; // total mA given to each subsystem
+    int sentLimits[static_cast<int>(PowerSubsystem::COUNT)] = {};  // per motor limit last sent, 0 if never
+    double draws[static_cast<int>(PowerSubsystem::COUNT)] = {};    // total mA each subsystem drew last update
+    int commandTimes[static_cast<int>(PowerSubsystem::COUNT)] = {}; // last time each subsystem was commanded in ms
+    double restingVoltage = 0; // battery voltage in mV the last time the motors were nearly idle
+
+    static int motorCount(PowerSubsystem subsystem);
+    static double readDraw(PowerSubsystem subsystem);
+    static void sendLimit(PowerSubsystem subsystem, int limit);
+
+public:
+    /**
+     * @brief Change which subsystem gets first claim on the budget.
+     */
+    void setMode(PowerMode newMode);
+
+    /**
+     * @brief Note that a subsystem was just told to move, so it gets current before its draw rises.
+     */
+    void command(PowerSubsystem subsystem);
+
+    /**
+     * @brief Gets the current priority mode.
+     */
+    PowerMode getMode();
+
+    /**
+     * @brief Measure each subsystem's draw, reallocate the budget and send the new limits.
+     */
+    void update();
+
+    /**
+     * @brief Gets the current given to a subsystem.
+     * @return total mA across the subsystem's motors
+     */
+    int getAllocation(PowerSubsystem subsystem);
+
+    /**
+     * @brief Gets the current a subsystem drew at the last update.
+     * @return total mA across the subsystem's motors
+     */
+    int getDraw(PowerSubsystem subsystem);
+
+    /**
+     * @brief Gets how far the battery has sagged below its resting voltage.
+     * @return mV of sag
+     */
+    int getSag();
+
+    /**
+     * @brief Print allocations, draws and sag to a line of the brain screen.
+     */
+    void printTelemetry(int line);
+};
+
+// Task that reallocates the current budget every control cycle
+void power_task(void* param);
+
+#endif // POWER_H
@@ -0,0 +1,107 @@
+#ifndef RESOURCE_MONITOR_H
+#define RESOURCE_MONITOR_H
+
+#include <cstddef>
+#include "pros/rtos.hpp"
+
+namespace ResourceConfig {
+    /** @brief Names of the tasks whose stacks are watched. */
+    extern const char* const TASK_NAMES[];
+
+    /** @brief Number of entries in TASK_NAMES. */
+    constexpr int TASK_COUNT = 21;
+
+    /** @brief Unused stack in words below which a task gets a warning. */
+    extern const int STACK_MARGIN;
+
+    /** @brief Growth in heap use in bytes since the first sample that gets a warning. */
+    extern const int HEAP_GROWTH;
+
+    /** @brief Time between samples in ms. */
+    extern const int UPDATE_RATE;
+
+    /** @brief Time between full reports to the terminal in ms. */
+    extern const int REPORT_RATE;
+}
+
+/**
+ * @struct HeapStats
+ * @brief Snapshot of the newlib heap.
+ */
+struct HeapStats {
+    std::size_t arena;      ///< bytes the heap has claimed from the system
+    std::size_t used;       ///< bytes handed out by malloc and new
+    std::size_t free;       ///< bytes free inside the arena
+    std::size_t releasable; ///< free bytes at the very top of the arena that could be given back, not the largest free block
+    int freeChunks;         ///< number of separate free chunks, says nothing about their sizes
+};
+
+/**
+ * @class ResourceMonitor
+ * @brief Tracks how close each task is to overflowing its stack and how the heap grows.
+ *
+ * The stack high water mark is the least unused stack a task has ever had, in
+ * words, so it only goes down. Tasks are found by name every sample because
+ * test tasks come and go, and a task that isn't running keeps its last mark.
+ * Each task and the heap warn once when they cross their threshold.
+ */
+class ResourceMonitor {
+private:
+    pros::Mutex mutex;
+    int highWater[ResourceConfig::TASK_COUNT];   // words, -1 if the task has never been seen
+    bool running[ResourceConfig::TASK_COUNT] = {};
+    bool stackWarned[ResourceConfig::TASK_COUNT] = {};
+    HeapStats heap = {};
+    std::size_t startUsed = 0; // heap in use at the first sample
+    bool heapWarned = false;
+
+    static HeapStats readHeap();
+
+public:
+    ResourceMonitor();
+
+    /**
+     * @brief Sample every watched task's stack and the heap.
+     */
+    void update();
+
+    /**
+     * @brief Gets the least unused stack a task has had.
+     * @param name one of TASK_NAMES
+     * @return words of stack never used, or -1 if the task hasn't been seen
+     */
+    int getHighWater(const char* name);
+
+    /**
+     * @brief Gets the task closest to overflowing its stack.
+     * @param margin filled with its unused stack in words
+     * @return its name, or nullptr if no task has been seen
+     */
+    const char* getTightestTask(int& margin);
+
+    /**
+     * @brief Gets the heap as of the last sample.
+     */
+    HeapStats getHeap();
+
+    /**
+     * @brief Gets how much heap use has grown since the first sample.
+     * @return bytes, negative if it has shrunk
+     */
+    long getHeapGrowth();
+
+    /**
+     * @brief Print the tightest stack and heap use to a line of the brain screen.
+     */
+    void printTelemetry(int line);
+
+    /**
+     * @brief Print every task's stack margin and the heap to the terminal, for right-sizing stacks.
+     */
+    void printReport();
+};
+
+// Task that samples stacks and the heap
+void resource_monitor_task(void* param);
+
+#endif // RESOURCE_MONITOR_H
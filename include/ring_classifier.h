@@ -0,0 +1,174 @@
+#ifndef RING_CLASSIFIER_H
+#define RING_CLASSIFIER_H
+
+#include <cstdint>
+#include "pros/optical.h"
+
+namespace ClassifierConfig {
+    /** @brief Trained lookup table on the SD card, made by tools/ring_lut_train. */
+    extern const char* LUT_FILE;
+
+    /** @brief CSV file on the SD card labeled samples are recorded to for training. */
+    extern const char* SAMPLE_FILE;
+
+    /** @brief Venue calibration on the SD card, made by RingClassifier::calibrate. */
+    extern const char* CALIBRATION_FILE;
+
+    /** @brief Time in ms each of red, blue and empty is sampled for during calibration. */
+    extern const int CALIBRATION_TIME;
+
+    /** @brief Standard deviations from a calibrated signature a cell can be and still be that ring. */
+    extern const double SIGNATURE_DEVIATIONS;
+
+    /** @brief Bins for each of the red and green chromaticity channels. */
+    constexpr int CHROMA_BINS = 16;
+
+    /** @brief Bins for brightness, log2 of the clear channel. */
+    constexpr int BRIGHTNESS_BINS = 4;
+
+    /** @brief Bins for proximity. */
+    constexpr int PROXIMITY_BINS = 4;
+
+    /** @brief Number of cells in the lookup table. */
+    constexpr int TABLE_SIZE = CHROMA_BINS * CHROMA_BINS * BRIGHTNESS_BINS * PROXIMITY_BINS;
+}
+
+/**
+ * @enum RingClass
+ * @brief What the ring sensor is looking at.
+ */
+enum class RingClass : std::uint8_t {
+    EMPTY, ///< no ring, or not sure enough to call it one
+    RED,
+    BLUE
+};
+
+/**
+ * @struct RingSignature
+ * @brief Hue and proximity distribution of one class, learned at a venue.
+ */
+struct RingSignature {
+    double hue = 0;                ///< circular mean hue in degrees
+    double hueDeviation = 0;       ///< standard deviation of the hue in degrees
+    double proximity = 0;          ///< mean proximity
+    double proximityDeviation = 0; ///< standard deviation of the proximity
+    int samples = 0;
+};
+
+/**
+ * @struct RingCalibration
+ * @brief Signatures of red rings, blue rings and an empty intake under one venue's lighting.
+ */
+struct RingCalibration {
+    RingSignature red;
+    RingSignature blue;
+    RingSignature empty;
+
+    /**
+     * @brief Load a calibration from the SD card.
+     * @return true if all three signatures were loaded
+     */
+    bool load(const char* path);
+
+    /**
+     * @brief Save the calibration to the SD card.
+     * @return true if the calibration was saved
+     */
+    bool save(const char* path) const;
+};
+
+/**
+ * @class RingClassifier
+ * @brief Classifies a single ring sensor sample with a lookup table.
+ *
+ * Each sample is reduced to red and green chromaticity (each channel over the
+ * sum of all three, so it doesn't change with brightness), brightness and
+ * proximity, and quantized into one cell of the table. Every cell holds the
+ * class trained for it, so classifying is one lookup. Cells the training data
+ * wasn't sure about are EMPTY, so a single RED or BLUE sample can be trusted.
+ *
+ * The table comes from, in order of preference, a calibration taken at this
+ * venue, a table trained off the robot, or the RingColor hue bands. It is only
+ * changed during initialize, before any task reads it.
+ */
+class RingClassifier {
+private:
+    std::uint8_t table[ClassifierConfig::TABLE_SIZE] = {}; // every cell EMPTY until init
+
+public:
+    /**
+     * @brief Build the table from the RingColor hues, then replace it with the calibrated or trained one if the SD
+     * card has it.
+     *
+     * Called from initialize since the RingColor hues aren't ready while globals are constructed.
+     *
+     * @return true if a calibrated or trained table was loaded
+     */
+    bool init();
+
+    /**
+     * @brief Learn the red, blue and empty signatures under this venue's lighting and rebuild the table from them.
+     *
+     * Prompts on the screen to hold red rings, then blue rings, then nothing at the sensor, for CALIBRATION_TIME each.
+     * The calibration is saved to the SD card so it is used every startup until the next one.
+     *
+     * @return true if every class got samples and the table was rebuilt
+     */
+    bool calibrate();
+
+    /**
+     * @brief Gets the table cell a sample falls in.
+     * @return index into the table, or -1 if the sample is unreadable
+     */
+    static int cellIndex(const pros::c::optical_raw_s_t& raw, int proximity);
+
+    /**
+     * @brief Fill the table from hue bands, what ColorSort used before there was training data.
+     *
+     * @param redHue center hue of red rings
+     * @param blueHue center hue of blue rings
+     * @param range one sided hue range around each center
+     * @param minProximity closest proximity that counts as a ring being in the intake
+     */
+    void buildFromHue(double redHue, double blueHue, double range, int minProximity);
+
+    /**
+     * @brief Fill the table from calibrated signatures.
+     *
+     * Each cell goes to the class whose signature it is closest to, measured in standard deviations of hue and
+     * proximity, and is only a ring if that is within SIGNATURE_DEVIATIONS.
+     */
+    void buildFromCalibration(const RingCalibration& calibration);
+
+    /**
+     * @brief Replace the table with a trained one from the SD card.
+     * @return true if a complete table was loaded
+     */
+    bool load(const char* path);
+
+    /**
+     * @brief Save the table to the SD card.
+     * @return true if the table was saved
+     */
+    bool save(const char* path) const;
+
+    /**
+     * @brief Set the class of one cell.
+     */
+    void setCell(int index, RingClass ringClass);
+
+    /**
+     * @brief Classify a sample.
+     */
+    RingClass classify(const pros::c::optical_raw_s_t& raw, int proximity) const;
+
+    /**
+     * @brief Read the ring sensor and classify it.
+     */
+    RingClass sample() const;
+};
+
+// Records labeled red, blue and empty samples to the SD card for tools/ring_lut_train
+void recordRingSamples(int i);
+
+#endif // RING_CLASSIFIER_H
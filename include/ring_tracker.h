@@ -0,0 +1,145 @@
+#ifndef RING_TRACKER_H
+#define RING_TRACKER_H
+
+#include "pros/rtos.hpp"
+
+namespace RingTrackerConfig {
+    /** @brief Time between samples in ms, the fastest the motor and optical sensor report. */
+    extern const int SAMPLE_RATE;
+
+    /** @brief Intake speed in rpm it has to be running at before dips are looked for. */
+    extern const double RUNNING_VELOCITY;
+
+    /** @brief Rise in current in mA over the free running current that marks a ring being pulled in. */
+    extern const double CURRENT_RISE;
+
+    /** @brief Fraction of free running speed the intake has to drop by to mark a ring. */
+    extern const double VELOCITY_DIP;
+
+    /** @brief Shortest dip in ms that counts as a ring, shorter ones are noise. */
+    extern const int MIN_DIP_TIME;
+
+    /** @brief Longest dip in ms that counts as a ring, longer ones are jams. */
+    extern const int MAX_DIP_TIME;
+
+    /** @brief Time in ms after a ring before another one can be seen by the same detector. */
+    extern const int REFRACTORY_TIME;
+
+    /** @brief Time in ms between a current and an optical detection for them to be the same ring. */
+    extern const int FUSION_WINDOW;
+
+    /** @brief Time in ms rings per second is measured over. */
+    extern const int THROUGHPUT_WINDOW;
+
+    /** @brief Number of recent ring events kept. */
+    constexpr int MAX_EVENTS = 32;
+}
+
+/**
+ * @enum RingSource
+ * @brief Bit flags for which detectors saw a ring.
+ */
+enum RingSource {
+    RING_SOURCE_CURRENT = 1 << 0, ///< intake current and speed dip
+    RING_SOURCE_OPTICAL = 1 << 1  ///< ring sensor proximity
+};
+
+/**
+ * @enum RingEventColor
+ * @brief Color of a ring event, unknown if the optical sensor missed it.
+ */
+enum class RingEventColor {
+    UNKNOWN,
+    RED,
+    BLUE
+};
+
+/**
+ * @struct RingEvent
+ * @brief One ring going through the intake.
+ */
+struct RingEvent {
+    int time;             ///< time the ring was first seen in ms
+    int sources;          ///< RingSource flags of the detectors that saw it
+    RingEventColor color; ///< color from the optical sensor
+};
+
+/**
+ * @class RingTracker
+ * @brief Counts rings going through the intake from the intake motor and the ring sensor.
+ *
+ * A ring being pulled in loads the intake, so the motor's current jumps while
+ * its speed dips for a moment. That dip is found against the free running
+ * current and speed, which means rings are still counted when the optical
+ * sensor misses them or isn't plugged in. Detections from both are merged into
+ * one stream of timestamped events.
+ */
+class RingTracker {
+private:
+    pros::Mutex mutex;
+    RingEvent events[RingTrackerConfig::MAX_EVENTS];
+    int eventCount = 0; // events seen since the last reset, the newest is at (eventCount - 1) % MAX_EVENTS
+
+    // current detector, only touched by the tracker task
+    double baseCurrent = 0;  // free running current in mA
+    double baseVelocity = 0; // free running speed in rpm
+    int dipStart = -1;       // time the current dip started, -1 if not dipping
+    int lastCurrentRing = -1;
+
+    // optical detector, only touched by the tracker task
+    bool ringInView = false;
+    int lastOpticalRing = -1;
+
+    void addDetection(int time, RingSource source, RingEventColor color);
+    void updateCurrent(int time);
+    void updateOptical(int time);
+
+public:
+    /**
+     * @brief Sample both detectors and add any new rings to the stream.
+     */
+    void update();
+
+    /**
+     * @brief Gets the number of rings seen since the last reset.
+     */
+    int getRingCount();
+
+    /**
+     * @brief Gets how fast rings are going through the intake.
+     * @return rings per second over the last THROUGHPUT_WINDOW
+     */
+    double getThroughput();
+
+    /**
+     * @brief Gets the newest ring event.
+     * @param event filled with the newest event
+     * @return false if no rings have been seen since the last reset
+     */
+    bool getLastEvent(RingEvent& event);
+
+    /**
+     * @brief Copy the recent ring events, oldest first.
+     * @param out buffer for the events
+     * @param max size of the buffer
+     * @return number of events copied
+     */
+    int getEvents(RingEvent* out, int max);
+
+    /**
+     * @brief Wait until a new ring is seen by either detector or it times out.
+     * @param msecTimeout timeout in milliseconds
+     * @return true if a ring was seen before the timeout
+     */
+    bool waitForRing(int msecTimeout);
+
+    /**
+     * @brief Forget all ring events.
+     */
+    void reset();
+};
+
+// Task that samples the intake and ring sensor for rings
+void ring_tracker_task(void* param);
+
+#endif // RING_TRACKER_H
@@ -0,0 +1,109 @@
+#ifndef SYSID_H
+#define SYSID_H
+
+#include <cstdint>
+#include <cstdio>
+
+namespace SysidConfig {
+    /** @brief CSV file on the SD card every sysid sample is logged to. */
+    extern const char* LOG_FILE;
+
+    /** @brief Time between samples in ms. */
+    extern const int SAMPLE_RATE;
+
+    /** @brief How fast the quasistatic test ramps voltage, in mV per second. */
+    extern const int RAMP_RATE;
+
+    /** @brief Length of the quasistatic test in ms. */
+    extern const int RAMP_TIME;
+
+    /** @brief Voltage of the dynamic test in mV. */
+    extern const int STEP_VOLTAGE;
+
+    /** @brief Length of the dynamic test in ms. */
+    extern const int STEP_TIME;
+
+    /** @brief Slowest wheel speed in inches per second used in the fit, slower samples are mostly static friction. */
+    extern const double MIN_VELOCITY;
+
+    /** @brief Most samples one test can record. */
+    constexpr int MAX_SAMPLES = 600;
+}
+
+/**
+ * @enum SysidTest
+ * @brief Kinds of sysid test.
+ */
+enum class SysidTest {
+    QUASISTATIC, ///< slow voltage ramp, the robot barely accelerates so it measures kS and kV
+    DYNAMIC      ///< voltage step, the robot accelerates hard so it measures kA
+};
+
+/**
+ * @struct SysidSample
+ * @brief One sample of a sysid test, speeds are of the wheels along the ground.
+ */
+struct SysidSample {
+    std::uint32_t time; ///< ms since the test started
+    float voltage;      ///< commanded voltage in mV
+    float velocity;     ///< wheel speed in inches per second
+    float acceleration; ///< wheel acceleration in inches per second squared
+};
+
+/**
+ * @struct Feedforward
+ * @brief Feedforward constants fit from sysid samples.
+ *
+ * The voltage a side needs is kS * sign(velocity) + kV * velocity + kA * acceleration.
+ */
+struct Feedforward {
+    double kS;       ///< mV to overcome static friction
+    double kV;       ///< mV per inch per second
+    double kA;       ///< mV per inch per second squared
+    double rSquared; ///< how much of the voltage the fit explains, 1 is perfect
+    int samples;     ///< samples used in the fit
+    bool valid;      ///< false if there were too few samples or they didn't constrain the fit
+};
+
+/**
+ * @brief Run one sysid test and record samples.
+ *
+ * Commands voltage straight to left_motors and right_motors, bypassing lemlib.
+ * Needs about 3 feet of clear space in the direction of travel.
+ *
+ * @param test quasistatic ramp or dynamic step
+ * @param angular true to turn clockwise in place, false to drive forward
+ * @param forwards false to run the test in reverse
+ * @param samples buffer for the samples
+ * @param maxSamples size of the buffer
+ * @return number of samples recorded
+ */
+int runSysidTest(SysidTest test, bool angular, bool forwards, SysidSample* samples, int maxSamples);
+
+/**
+ * @brief Fit feedforward constants to samples with ordinary least squares.
+ *
+ * @param samples samples from quasistatic and dynamic tests of the same motion
+ * @param count number of samples
+ */
+Feedforward fitFeedforward(const SysidSample* samples, int count);
+
+/**
+ * @brief Voltage a side needs for a wheel speed and acceleration.
+ *
+ * @return voltage in mV, clamped to the motor's +-12000 mV range
+ */
+double feedforwardVoltage(const Feedforward& feedforward, double velocity, double acceleration);
+
+/**
+ * @brief Write samples to an open sysid log as CSV rows.
+ *
+ * Rows are motion,test,direction,time,voltage,velocity,acceleration.
+ */
+void writeSysidSamples(FILE* file, bool angular, SysidTest test, bool forwards, const SysidSample* samples,
+                       int count);
+
+// Runs every sysid test for linear and angular motion, logs them to the SD card and fits both
+void runSysid(int i);
+
+#endif // SYSID_H
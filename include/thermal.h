@@ -0,0 +1,131 @@
+#ifndef THERMAL_H
+#define THERMAL_H
+
+#include "pros/rtos.hpp"
+
+namespace ThermalConfig {
+    /** @brief Winding resistance of a V5 motor in ohms, heat is current squared times this. */
+    extern const double WINDING_RESISTANCE;
+
+    /** @brief Thermal resistance from the motor to the air in degrees C per watt. */
+    extern const double THERMAL_RESISTANCE;
+
+    /** @brief Heat capacity of the motor in joules per degree C. */
+    extern const double HEAT_CAPACITY;
+
+    /** @brief Temperature in degrees C the firmware starts cutting motor power at. */
+    extern const double THROTTLE_TEMP;
+
+    /** @brief Time to throttle in ms below which derating starts, a full skills run. */
+    extern const int HORIZON;
+
+    /** @brief Smallest fraction of acceleration derating will cut down to. */
+    extern const double MIN_DERATE;
+
+    /** @brief Slew used in place of an unlimited one while derating, in output per loop. */
+    extern const double UNLIMITED_SLEW;
+
+    /** @brief Most a driver drive command can change per loop in rpm, scaled by the derate. */
+    extern const double DRIVER_SLEW;
+
+    /** @brief Time between model updates in ms. */
+    extern const int UPDATE_RATE;
+}
+
+/**
+ * @enum ThermalMotor
+ * @brief Motors the thermal model tracks, in the order motor_temp_task prints them.
+ */
+enum class ThermalMotor {
+    LM1, LM2, LM3,
+    RM1, RM2, RM3,
+    INT,
+    OC,
+    COUNT
+};
+
+/**
+ * @class ThermalMonitor
+ * @brief Lumped thermal model of each motor that predicts when the firmware will throttle it.
+ *
+ * Each motor is one heat capacity warmed by current squared through the winding
+ * and cooled through a thermal resistance to the air. The model is corrected
+ * toward the motor's own temperature reading whenever they disagree by more than
+ * the reading's 5 degree steps. When the hottest drive motor would throttle
+ * before the horizon, chassis acceleration is softened so the drive stays at
+ * full speed for the whole run instead of losing power partway.
+ */
+class ThermalMonitor {
+private:
+    struct MotorState {
+        double temperature = 0; // modelled temperature in degrees C, 0 until the first update
+        double current = 0;     // filtered current in amps
+        int timeToThrottle = -1; // ms until throttle at the current load, -1 if it never will
+    };
+
+    pros::Mutex mutex;
+    MotorState motors[static_cast<int>(ThermalMotor::COUNT)];
+    double ambient = 0;  // temperature of the air in degrees C, taken from the coolest motor at startup
+    double derate = 1;   // fraction of acceleration allowed, 1 is none taken away
+    double appliedDerate = 1; // derate the chassis slew was last set for
+    int lastUpdate = -1;
+
+    static double readTemperature(ThermalMotor motor);
+    static double readCurrent(ThermalMotor motor);
+    void applyDerate(double newDerate);
+
+public:
+    /**
+     * @brief Advance the model of every motor and update the derate.
+     */
+    void update();
+
+    /**
+     * @brief Gets the modelled temperature of a motor.
+     * @return degrees C
+     */
+    double getTemperature(ThermalMotor motor);
+
+    /**
+     * @brief Gets how long a motor can hold its current load before it throttles.
+     * @return ms until throttle, 0 if already throttling, or -1 if it never will at this load
+     */
+    int getTimeToThrottle(ThermalMotor motor);
+
+    /**
+     * @brief Gets how much of a motor's thermal headroom is left.
+     * @return 1 at ambient temperature down to 0 at the throttle temperature
+     */
+    double getBudget(ThermalMotor motor);
+
+    /**
+     * @brief Gets the budget of the hottest drive motor.
+     * @return 1 at ambient temperature down to 0 at the throttle temperature
+     */
+    double getDriveBudget();
+
+    /**
+     * @brief Gets the shortest time to throttle of the drive motors.
+     * @return ms until throttle, 0 if one is already throttling, or -1 if none ever will at this load
+     */
+    int getDriveTimeToThrottle();
+
+    /**
+     * @brief Gets the fraction of acceleration the drive is allowed.
+     * @return 1 for full acceleration down to ThermalConfig::MIN_DERATE
+     */
+    double getDerate();
+
+    /**
+     * @brief Limit how fast a driver drive command can change while derating.
+     * @param target the new command in rpm
+     * @param current the last command sent in rpm
+     * @return the command to send
+     */
+    double limitDriveAcceleration(double target, double current);
+};
+
+// Task that keeps the thermal model of every motor up to date
+void thermal_task(void* param);
+
+#endif // THERMAL_H
@@ -0,0 +1,106 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <atomic>
+#include <cstdint>
+#include "pros/rtos.h"
+
+// Set TRACE in the Makefile to 1 to record trace zones, otherwise TRACE_ZONE compiles to nothing
+#ifndef TRACE_ENABLED
+#define TRACE_ENABLED 0
+#endif
+
+namespace TraceConfig {
+    /** @brief Most tasks that can record, later tasks share the last buffer. */
+    constexpr int MAX_TASKS = 16;
+
+    /** @brief Events kept per task, older ones are overwritten. */
+    constexpr int EVENTS_PER_TASK = 2048; // 10 s of a 10 ms loop with one zone
+
+    /** @brief Length of a task name kept for the dump. */
+    constexpr int NAME_LENGTH = 32;
+
+    /** @brief CSV file on the SD card the trace is dumped to, tools/trace_to_chrome converts it. */
+    extern const char* TRACE_FILE;
+}
+
+/**
+ * @struct TraceEvent
+ * @brief Start or end of one zone.
+ */
+struct TraceEvent {
+    std::uint32_t time; ///< pros::micros, wraps after about 71 minutes
+    const char* name;   ///< zone name, always a string literal
+    bool begin;         ///< true when the zone starts, false when it ends
+};
+
+/**
+ * @class Tracer
+ * @brief Records zone begin and end events from every task into per-task ring buffers.
+ *
+ * Each task claims a buffer the first time it records and is the only writer
+ * of it, so recording takes no lock: it is a micros read, three stores and a
+ * release of the head. The dump pauses recording while it copies out, so
+ * events are only lost or torn if a task was preempted mid-record right then.
+ *
+ * The buffers take about 400 KB, so the tracer only exists when TRACE_ENABLED is set.
+ */
+class Tracer {
+public:
+    struct TaskBuffer {
+        std::atomic<bool> claimed = false;
+        std::atomic<bool> ready = false;
+        pros::task_t task = nullptr;
+        char name[TraceConfig::NAME_LENGTH] = {};
+        TraceEvent events[TraceConfig::EVENTS_PER_TASK] = {};
+        std::atomic<std::uint32_t> head = 0; // events recorded so far, the next goes at head % EVENTS_PER_TASK
+    };
+
+    /**
+     * @brief Record an event for the current task.
+     */
+    void record(const char* name, bool begin);
+
+    /**
+     * @brief Write every task's recent events to a CSV file and clear them.
+     * @return true if the file was written
+     */
+    bool dump(const char* path);
+
+private:
+    TaskBuffer& currentBuffer();
+
+    TaskBuffer buffers[TraceConfig::MAX_TASKS];
+    std::atomic<bool> paused = false;
+};
+
+/**
+ * @class TraceZone
+ * @brief Records a zone from construction to the end of the scope, use through TRACE_ZONE.
+ */
+class TraceZone {
+private:
+    const char* name;
+
+public:
+    explicit TraceZone(const char* name);
+    ~TraceZone();
+};
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+
+#if TRACE_ENABLED
+/** @brief Record the rest of the enclosing scope as a zone on the timeline. */
+#define TRACE_ZONE(name) TraceZone TRACE_CONCAT(traceZone, __LINE__)(name)
+#else
+#define TRACE_ZONE(name) (void)0
+#endif
+
+/**
+ * @brief Dump the trace to the SD card if tracing is compiled in.
+ * @return true if a trace was written
+ */
+bool dumpTrace();
+
+#endif // TRACE_H
@@ -0,0 +1,221 @@
+#ifndef TRIGGER_CHASSIS_H
+#define TRIGGER_CHASSIS_H
+
+#include <atomic>
+#include <functional>
+#include "lemlib/chassis/chassis.hpp"
+#include "pros/rtos.hpp"
+
+namespace TriggerConfig {
+    /** @brief How often the trigger task checks its triggers, in milliseconds. */
+    extern const int POLL_RATE;
+}
+
+namespace CalibrationConfig {
+    /** @brief Time in ms the heading is watched for drift after the IMU calibrates. */
+    extern const int STILL_TIME;
+
+    /** @brief Drift in degrees per second above which the calibration is reported as bad. */
+    extern const double MAX_DRIFT;
+
+    /** @brief Longest time in ms a motion waits for calibration before going without it. */
+    extern const int READY_TIMEOUT;
+}
+
+/**
+ * @enum TriggerType
+ * @brief What a motion trigger is keyed on.
+ */
+enum class TriggerType {
+    DISTANCE, ///< inches traveled (degrees turned for turns)
+    PROGRESS, ///< fraction of the motion completed, 0 to 1
+    TIME      ///< milliseconds since the motion started
+};
+
+/**
+ * @class TriggerChassis
+ * @brief A lemlib chassis that can fire actions partway through a motion.
+ *
+ * Triggers are added before a motion is started and are attached to the next
+ * motion. The trigger task checks them every few milliseconds while the motion
+ * runs and fires each action once, the first cycle its condition is met.
+ * Triggers whose condition is never met are dropped when the motion ends.
+ *
+ * @code {.cpp}
+ * chassis.atTime(800, []() { left_doinker.extend(); });
+ * chassis.moveToPoint(10, 20, 2000);
+ * chassis.waitUntilDone();
+ * @endcode
+ *
+ * @note Actions run on the trigger task, so they should be quick (pistons, motor commands).
+ */
+class TriggerChassis : public lemlib::Chassis {
+public:
+    using lemlib::Chassis::Chassis;
+
+    /**
+     * @brief Fire an action once the next motion has traveled a distance.
+     *
+     * @param dist inches for lateral motions, degrees for turns and swings
+     * @param action the action to fire
+     * @return true if the trigger was added, false if there was no room
+     */
+    bool atDistance(float dist, std::function<void()> action);
+
+    /**
+     * @brief Fire an action once the next motion is a fraction of the way done.
+     *
+     * @param fraction how far through the motion to fire, from 0 to 1
+     * @param action the action to fire
+     * @return true if the trigger was added, false if there was no room
+     */
+    bool atProgress(float fraction, std::function<void()> action);
+
+    /**
+     * @brief Fire an action a set time after the next motion starts.
+     *
+     * @param msec milliseconds after the motion starts
+     * @param action the action to fire
+     * @return true if the trigger was added, false if there was no room
+     */
+    bool atTime(int msec, std::function<void()> action);
+
+    /**
+     * @brief Remove all triggers that have not fired yet.
+     */
+    void clearTriggers();
+
+    /**
+     * @brief Get how far the current motion has traveled.
+     *
+     * @return inches (degrees for turns) traveled, or -1 if no motion is running
+     */
+    float getDistTraveled() const;
+
+    /**
+     * @brief Get the settings of the lateral controller.
+     */
+    lemlib::ControllerSettings getLateralSettings() const;
+
+    /**
+     * @brief Get the settings of the angular controller.
+     */
+    lemlib::ControllerSettings getAngularSettings() const;
+
+    /**
+     * @brief Replace the lateral controller gains and exit conditions, used to apply tuned settings.
+     *
+     * @note Only call this while no motion is running.
+     */
+    void setLateralSettings(const lemlib::ControllerSettings& settings);
+
+    /**
+     * @brief Replace the angular controller gains and exit conditions, used to apply tuned settings.
+     *
+     * @note Only call this while no motion is running.
+     */
+    void setAngularSettings(const lemlib::ControllerSettings& settings);
+
+    /**
+     * @brief Change only the maximum acceleration of both controllers.
+     *
+     * Safe while a motion is running, the motion loop reads the slew every cycle.
+     *
+     * @param lateralSlew lateral slew, 0 for no limit
+     * @param angularSlew angular slew, 0 for no limit
+     */
+    void setSlew(float lateralSlew, float angularSlew);
+
+    /**
+     * @brief Calibrate the chassis sensors on their own task so initialize doesn't block on the IMU.
+     *
+     * Motions and setPose wait for calibration to finish if it's still running, so routes don't need to.
+     * Once calibrated, the heading is watched for STILL_TIME to measure drift.
+     */
+    void calibrateAsync();
+
+    /**
+     * @brief Run the calibration and drift measurement, called by the calibration task.
+     */
+    void runCalibration();
+
+    /**
+     * @brief Gets whether calibration has finished.
+     */
+    bool isCalibrated() const;
+
+    /**
+     * @brief Wait for calibration to finish, returns right away if it already has.
+     * @param msecTimeout timeout in milliseconds
+     * @return true if calibration finished before the timeout
+     */
+    bool waitUntilCalibrated(int msecTimeout = CalibrationConfig::READY_TIMEOUT);
+
+    /**
+     * @brief Gets the heading drift measured while the robot sat still after calibrating.
+     * @return drift in degrees per second, or -1 if it hasn't been measured
+     */
+    float getHeadingDrift() const;
+
+    // setPose is wrapped so a pose set before calibration finishes isn't reset by it
+    void setPose(float x, float y, float theta, bool radians = false);
+    void setPose(lemlib::Pose pose, bool radians = false);
+
+    /**
+     * @brief Check the triggers of the current motion and fire any that are due.
+     *
+     * Called by the trigger task, routes should not need to call this.
+     */
+    void updateTriggers();
+
+    // Motions are wrapped so the chassis knows when each one starts and how long it is
+    void turnToPoint(float x, float y, int timeout, lemlib::TurnToPointParams params = {}, bool async = true);
+    void turnToHeading(float theta, int timeout, lemlib::TurnToHeadingParams params = {}, bool async = true);
+    void swingToHeading(float theta, lemlib::DriveSide lockedSide, int timeout, lemlib::SwingToHeadingParams params = {},
+                        bool async = true);
+    void swingToPoint(float x, float y, lemlib::DriveSide lockedSide, int timeout, lemlib::SwingToPointParams params = {},
+                      bool async = true);
+    void moveToPose(float x, float y, float theta, int timeout, lemlib::MoveToPoseParams params = {}, bool async = true);
+    void moveToPoint(float x, float y, int timeout, lemlib::MoveToPointParams params = {}, bool async = true);
+
+private:
+    static constexpr int MAX_TRIGGERS = 16; ///< maximum number of triggers waiting at once
+
+    enum class TriggerState {
+        EMPTY,   ///< slot is free
+        PENDING, ///< waiting for the next motion to start
+        ACTIVE,  ///< attached to the current motion
+        FIRING   ///< action is running
+    };
+
+    struct Trigger {
+        TriggerType type;
+        float threshold;
+        std::function<void()> action;
+        TriggerState state = TriggerState::EMPTY;
+    };
+
+    bool addTrigger(TriggerType type, float threshold, std::function<void()> action);
+    int motionCallTime();
+    void startMotion(int callTime, float remaining);
+    void finishMotion(bool async);
+    float turnLength(float theta, lemlib::AngularDirection direction);
+    float pointHeading(float x, float y, bool forwards);
+
+    Trigger triggers[MAX_TRIGGERS];
+    int motionStartTime = 0;   ///< time the current motion started in milliseconds
+    float motionLength = 0;    ///< expected length of the current motion
+    pros::Mutex triggerMutex;
+
+    std::atomic<bool> calibrating = false;
+    std::atomic<bool> calibrated = false;
+    std::atomic<float> headingDrift = -1; ///< degrees per second, -1 until measured
+};
+
+// Task that fires motion triggers, runs above the default priority so it preempts the motion task
+void motion_trigger_task(void* param);
+
+// Task that calibrates the chassis passed as param
+void calibration_task(void* param);
+
+#endif // TRIGGER_CHASSIS_H
@@ -0,0 +1,199 @@
+#include "actuator_scheduler.h"
+#include "lemlib/api.hpp" // IWYU pragma: keep
+#include <climits>
+#include <cstdlib>
+#include <iostream>
+#include "devices.h"
+
+const int WHEEL_MASK = SchedulerConfig::WHEEL_SIZE - 1;
+
+bool ActuatorScheduler::callAt(int time, void (*action)()) {
+    return post({CommandType::CALL, time, action, nullptr, nullptr});
+}
+bool ActuatorScheduler::callAfter(int msec, void (*action)()) {
+    return callAt(pros::millis() + msec, action);
+}
+bool ActuatorScheduler::extendAt(int time, Piston& piston) {
+    return post({CommandType::EXTEND, time, nullptr, &piston, nullptr});
+}
+bool ActuatorScheduler::extendAfter(int msec, Piston& piston) {
+    return extendAt(pros::millis() + msec, piston);
+}
+bool ActuatorScheduler::retractAt(int time, Piston& piston) {
+    return post({CommandType::RETRACT, time, nullptr, &piston, nullptr});
+}
+bool ActuatorScheduler::retractAfter(int msec, Piston& piston) {
+    return retractAt(pros::millis() + msec, piston);
+}
+
+bool ActuatorScheduler::post(Command command) {
+    {
+        std::lock_guard<pros::Mutex> lock(mutex);
+
+        // build the free list the first time a command is posted
+        if (!initialized) {
+            for (int i = 0; i < SchedulerConfig::MAX_COMMANDS; i++) {
+                commands[i].next = freeList;
+                freeList = &commands[i];
+            }
+            cursor = pros::millis();
+            initialized = true;
+        }
+
+        if (freeList == nullptr) {
+            pros::lcd::print(1, "WARN: Actuator command dropped b/c queue is full");
+            return false;
+        }
+
+        Command* slot = freeList;
+        freeList = freeList->next;
+        *slot = command;
+
+        // late commands go in the next slot the wheel will reach so they run right away
+        int slotTime = std::max(command.time, cursor + 1);
+        Command*& head = wheel[slotTime & WHEEL_MASK];
+        slot->next = head;
+        head = slot;
+        pending++;
+    }
+
+    // wake the scheduler task so it can start counting down to this command
+    if (task != nullptr) {
+        pros::c::task_notify(task);
+    }
+    return true;
+}
+
+void ActuatorScheduler::run(const Command& command) {
+    switch (command.type) {
+    case CommandType::CALL:
+        command.action();
+        break;
+    case CommandType::EXTEND:
+        command.piston->extend();
+        break;
+    case CommandType::RETRACT:
+        command.piston->retract();
+        break;
+    }
+}
+
+void ActuatorScheduler::cancelAll() {
+    std::lock_guard<pros::Mutex> lock(mutex);
+    for (Command*& head : wheel) {
+        while (head != nullptr) {
+            Command* command = head;
+            head = command->next;
+            command->next = freeList;
+            freeList = command;
+        }
+    }
+    pending = 0;
+}
+
+std::uint32_t ActuatorScheduler::update() {
+    Command* due = nullptr;
+    {
+        std::lock_guard<pros::Mutex> lock(mutex);
+        int now = pros::millis();
+
+        // nothing to run, so skip the wheel straight to now
+        if (pending == 0) {
+            cursor = now;
+            return TIMEOUT_MAX;
+        }
+
+        // advance the wheel one slot per millisecond, pulling out every command that is due
+        while (cursor < now) {
+            cursor++;
+            Command** link = &wheel[cursor & WHEEL_MASK];
+            while (*link != nullptr) {
+                Command* command = *link;
+                // commands more than a lap of the wheel away stay in their slot
+                if (command->time <= cursor) {
+                    *link = command->next;
+                    command->next = due;
+                    due = command;
+                    pending--;
+                } else {
+                    link = &command->next;
+                }
+            }
+        }
+    }
+
+    // run commands outside of the lock so routes can keep posting
+    for (Command* command = due; command != nullptr; command = command->next) {
+        run(*command);
+
+        int jitter = std::max(0, (int)(pros::micros() - (std::uint64_t)command->time * 1000));
+        runCount++;
+        totalJitter += jitter;
+        maxJitter = std::max(maxJitter, jitter);
+    }
+
+    std::lock_guard<pros::Mutex> lock(mutex);
+    while (due != nullptr) {
+        Command* command = due;
+        due = command->next;
+        command->next = freeList;
+        freeList = command;
+    }
+    if (pending == 0) {
+        return TIMEOUT_MAX;
+    }
+
+    // sleep until the earliest waiting command, a new post wakes the task sooner
+    int earliest = INT_MAX;
+    for (Command* head : wheel) {
+        for (Command* command = head; command != nullptr; command = command->next) {
+            earliest = std::min(earliest, command->time);
+        }
+    }
+    return std::max(1, earliest - static_cast<int>(pros::millis()));
+}
+
+int ActuatorScheduler::getPendingCount() {
+    std::lock_guard<pros::Mutex> lock(mutex);
+    return pending;
+}
+
+int ActuatorScheduler::getRunCount() const {
+    return runCount;
+}
+
+int ActuatorScheduler::getMaxJitter() const {
+    return maxJitter;
+}
+
+double ActuatorScheduler::getAverageJitter() const {
+    return runCount > 0 ? (double)totalJitter / runCount : 0;
+}
+
+void ActuatorScheduler::resetJitter() {
+    runCount = 0;
+    totalJitter = 0;
+    maxJitter = 0;
+}
+
+void ActuatorScheduler::printJitter() const {
+    std::cout << "actuator commands: " << getRunCount()
+              << " | avg jitter: " << getAverageJitter() << " us"
+              << " | max jitter: " << getMaxJitter() << " us"
+              << std::endl;
+}
+
+void ActuatorScheduler::attachTask(pros::task_t task) {
+    this->task = task;
+}
+
+// Task that runs actuator commands when they are due
+void actuator_scheduler_task(void *param) {
+    actuator_scheduler.attachTask(pros::c::task_get_current());
+    while (true) {
+        std::uint32_t sleepTime = actuator_scheduler.update();
+
+        // Sleep until the next command is due or a new one is posted
+        pros::Task::notify_take(true, sleepTime);
+    }
+}
@@ -0,0 +1,172 @@
+#include "alloc_tracker.h"
+#include "lemlib/api.hpp" // IWYU pragma: keep
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include "devices.h"
+
+namespace AllocConfig {
+    const int WARMUP_CYCLES = 5; // first cycles may fill caches or start async motions
+    const bool ASSERT_OFF_FIELD = true;
+}
+
+AllocTracker::TaskSlot& AllocTracker::currentSlot() {
+    pros::task_t current = pros::c::task_get_current();
+
+    for (TaskSlot& slot : tasks) {
+        if (slot.ready.load(std::memory_order_acquire) && slot.task == current) {
+            return slot;
+        }
+    }
+
+    // first allocation from this task, claim a free slot
+    for (TaskSlot& slot : tasks) {
+        bool expected = false;
+        if (slot.claimed.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
+            slot.task = current;
+            // copy the name since the task may be deleted before the report
+            const char* name = current == nullptr ? "startup" : pros::c::task_get_name(current);
+            strncpy(slot.name, name == nullptr ? "?" : name, AllocConfig::NAME_LENGTH - 1);
+            slot.ready.store(true, std::memory_order_release);
+            return slot;
+        }
+    }
+    return tasks[AllocConfig::MAX_TASKS - 1];
+}
+
+void AllocTracker::recordAlloc(std::size_t size) {
+    TaskSlot& slot = currentSlot();
+    slot.allocs.fetch_add(1, std::memory_order_relaxed);
+    slot.bytes.fetch_add(size, std::memory_order_relaxed);
+
+    if (slot.tag != nullptr) {
+        for (TagSlot& tagSlot : tags) {
+            const char* expected = nullptr;
+            if (tagSlot.tag.load(std::memory_order_acquire) == slot.tag ||
+                tagSlot.tag.compare_exchange_strong(expected, slot.tag, std::memory_order_acq_rel)) {
+                tagSlot.allocs.fetch_add(1, std::memory_order_relaxed);
+                tagSlot.bytes.fetch_add(size, std::memory_order_relaxed);
+                break;
+            }
+        }
+    }
+
+    // reported at the loop's next tick, printing from in here could allocate
+    if (slot.loop != nullptr && slot.cycles >= AllocConfig::WARMUP_CYCLES) {
+        slot.violationTag = slot.tag;
+        slot.violationSize = size;
+        slot.violations.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void AllocTracker::recordFree() {
+    currentSlot().frees.fetch_add(1, std::memory_order_relaxed);
+}
+
+int AllocTracker::getAllocCount(const char* taskName) {
+    for (TaskSlot& slot : tasks) {
+        if (slot.ready && strcmp(slot.name, taskName) == 0) {
+            return slot.allocs;
+        }
+    }
+    return -1;
+}
+
+void AllocTracker::printReport() {
+    printf("user code allocations, pros and lemlib aren't tracked\n");
+    printf("%-30s | %8s | %8s | %10s | %s\n", "task", "allocs", "frees", "bytes", "loop violations");
+    for (TaskSlot& slot : tasks) {
+        if (!slot.ready) continue;
+        printf("%-30s | %8d | %8d | %10ld | %d\n", slot.name, slot.allocs.load(), slot.frees.load(),
+               slot.bytes.load(), slot.violations.load());
+    }
+    for (TagSlot& tagSlot : tags) {
+        const char* tag = tagSlot.tag;
+        if (tag == nullptr) continue;
+        printf("tag %-26s | %8d | %8s | %10ld |\n", tag, tagSlot.allocs.load(), "", tagSlot.bytes.load());
+    }
+}
+
+AllocScope::AllocScope(const char* tag) {
+    AllocTracker::TaskSlot& slot = alloc_tracker.currentSlot();
+    previous = slot.tag;
+    slot.tag = tag;
+}
+
+AllocScope::~AllocScope() {
+    alloc_tracker.currentSlot().tag = previous;
+}
+
+LoopGuard::LoopGuard(const char* name) {
+    AllocTracker::TaskSlot& slot = alloc_tracker.currentSlot();
+    previousLoop = slot.loop;
+    previousCycles = slot.cycles;
+    slot.loop = name;
+    slot.cycles = 0;
+    slot.reported = slot.violations;
+}
+
+LoopGuard::~LoopGuard() {
+    AllocTracker::TaskSlot& slot = alloc_tracker.currentSlot();
+    slot.loop = previousLoop;
+    slot.cycles = previousCycles;
+}
+
+void LoopGuard::tick() {
+    AllocTracker::TaskSlot& slot = alloc_tracker.currentSlot();
+    slot.cycles++;
+    if (slot.violations == slot.reported) {
+        return;
+    }
+
+    printf("%s allocated %u bytes in loop %s (tag %s)\n", slot.name, static_cast<unsigned>(slot.violationSize),
+           slot.loop, slot.violationTag == nullptr ? "none" : slot.violationTag);
+    pros::lcd::print(1, "WARN: %s allocated %u bytes", slot.loop, static_cast<unsigned>(slot.violationSize));
+    // set after printing so anything the prints allocate isn't reported next tick
+    slot.reported = slot.violations;
+    if (AllocConfig::ASSERT_OFF_FIELD && !pros::competition::is_connected()) {
+        abort();
+    }
+}
+
+// Every allocation in this project's code comes through here, the cold image libraries use their own
+void* operator new(std::size_t size) {
+    alloc_tracker.recordAlloc(size);
+    void* pointer = malloc(size == 0 ? 1 : size);
+    if (pointer == nullptr) {
+        abort();
+    }
+    return pointer;
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    alloc_tracker.recordAlloc(size);
+    return malloc(size == 0 ? 1 : size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t& tag) noexcept {
+    return operator new(size, tag);
+}
+
+void operator delete(void* pointer) noexcept {
+    if (pointer == nullptr) return;
+    alloc_tracker.recordFree();
+    free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept {
+    operator delete(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept {
+    operator delete(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t) noexcept {
+    operator delete(pointer);
+}
@@ -4,13 +4,119 @@
 #include "devices.h"
 
 namespace Goal {
-    const int MIN_DETECTION = 3; // Amount of detections needed to quit loop
+    const int DETECTION_TIME = 60; // Time the goal has to be detected in a row before clamping, in ms
     const int MAX_DISTANCE = 10; // Maximum distance goal is to be counted
+    const int STROKE_TIME = 60; // Time for the clamp to close after it fires, in ms
+    const int MIN_PROXIMITY = 20; // Proximity where the goal is first trusted to be in view
+    const int MIN_CONFIDENCE = 2; // Amount of agreeing samples needed to fire early
+}
+
+const double RANGE_SCALE = 4.0; // Inches of range where proximity reads a quarter of max
+const double MAX_PROXIMITY = 255; // Proximity reading at contact
+const double SPEED_TOLERANCE = 0.5; // Fraction of drive speed the sensor speed may be off by
+const double MIN_SPEED_TOLERANCE = 2; // Inches per second the sensor speed may always be off by
+const double SENSOR_WEIGHT = 0.3; // How much the proximity trend counts in the closing speed
+const int SAMPLE_RATE = 10; // Time between predictor samples, in ms
+const int POLL_RATE = 20; // Time between samples when waiting on plain detection, in ms
+const int MIN_DETECTION = Goal::DETECTION_TIME / SAMPLE_RATE; // Amount of detections in a row at SAMPLE_RATE needed to clamp
+
+// Reflected light falls off with the square of distance, so range goes with 1/sqrt(proximity)
+double GoalPredictor::proximityToRange(int proximity) {
+    if (proximity <= 0) {
+        return RANGE_SCALE * MAX_PROXIMITY; // nothing in view, treat as far away
+    }
+    return RANGE_SCALE * (sqrt(MAX_PROXIMITY / std::min(proximity, (int)MAX_PROXIMITY)) - 1);
+}
+
+// The clamp is on the back of the robot, so reversing closes on the goal
+double GoalPredictor::getDriveClosingSpeed() {
+    double motorRPM = (left_motors.get_actual_velocity(0) + right_motors.get_actual_velocity(0)) / 2;
+    double wheelRPM = motorRPM * drivetrain.rpm / 600; // blue cartridge
+    return -wheelRPM * drivetrain.wheelDiameter * M_PI / 60;
+}
+
+void GoalPredictor::reset() {
+    lastTime = -1;
+    lastRange = 0;
+    sensorSpeed = 0;
+    driveSpeed = 0;
+    confidence = 0;
+}
+
+void GoalPredictor::update() {
+    int currentTime = pros::millis();
+    int proximity = goalSens.get_proximity();
+    // a faulted sensor reads PROS_ERR, which clamps to a goal at contact, so start over instead
+    if (proximity == PROS_ERR || !device_health.isHealthy(goalSens.get_port())) {
+        reset();
+        return;
+    }
+    double range = proximityToRange(proximity);
+    driveSpeed = getDriveClosingSpeed();
+
+    if (lastTime < 0) {
+        lastTime = currentTime;
+        lastRange = range;
+        return;
+    }
+
+    // the sensor only updates once per integration time, wait for a new reading
+    if (range == lastRange && proximity < MAX_PROXIMITY) {
+        return;
+    }
+
+    // smooth the closing speed seen by the sensor
+    double rangeRate = (lastRange - range) * 1000 / (currentTime - lastTime);
+    sensorSpeed = lemlib::ema(rangeRate, sensorSpeed, 0.5);
+    lastTime = currentTime;
+    lastRange = range;
+
+    // only trust the estimate while the goal is in view and both speeds agree it is closing
+    bool inView = proximity >= Goal::MIN_PROXIMITY;
+    bool agree = driveSpeed > 0 && sensorSpeed > 0
+              && fabs(sensorSpeed - driveSpeed) <= SPEED_TOLERANCE * driveSpeed + MIN_SPEED_TOLERANCE;
+    confidence = inView && agree ? confidence + 1 : 0;
+}
+
+double GoalPredictor::getRange() const {
+    return lastRange;
+}
+
+double GoalPredictor::getClosingSpeed() const {
+    if (confidence == 0) {
+        return driveSpeed;
+    }
+    return (1 - SENSOR_WEIGHT) * driveSpeed + SENSOR_WEIGHT * sensorSpeed;
+}
+
+double GoalPredictor::getTimeToContact() const {
+    double closingSpeed = getClosingSpeed();
+    if (closingSpeed <= 0) {
+        return INFINITY;
+    }
+    return lastRange / closingSpeed * 1000;
+}
+
+int GoalPredictor::getConfidence() const {
+    return confidence;
+}
+
+bool GoalPredictor::shouldFire() const {
+    // never fire on a sensor that has faulted since the last update
+    if (!device_health.isHealthy(goalSens.get_port())) {
+        return false;
+    }
+    // fire one sample early so the stroke finishes right at contact
+    return confidence >= Goal::MIN_CONFIDENCE && getTimeToContact() <= Goal::STROKE_TIME + SAMPLE_RATE;
 }
 
 bool AutoClamp::isActive = false;
 
 bool AutoClamp::isDetected() {
+    // a faulted sensor reads PROS_ERR, which looks like a goal right at the clamp
+    if (!device_health.isHealthy(goalSens.get_port())) {
+        return false;
+    }
     int currentGoalDist = 255 - goalSens.get_proximity(); // Get the current distance from the sensor
     bool inRange = currentGoalDist <= Goal::MAX_DISTANCE; // Determine if goal is within proximity
     return inRange;
@@ -33,7 +139,7 @@ void AutoClamp::waitUntilClamp(int maxDist, int maxTime) {
     pros::lcd::print(2, "Max Time: %d ms", maxTime);
 
     // Loop until goal is detected enough times or it times out
-    while (pros::millis() - startTime < maxTime && goalDetected < Goal::MIN_DETECTION && left_motors.get_position(0) > -maxDistRotations) {
+    while (pros::millis() - startTime < maxTime && goalDetected < Goal::DETECTION_TIME / POLL_RATE && left_motors.get_position(0) > -maxDistRotations) {
         bool detected = isDetected();
 
         if (detected) {
@@ -49,7 +155,43 @@ void AutoClamp::waitUntilClamp(int maxDist, int maxTime) {
         pros::lcd::print(4, "Goal Detected Count: %d", goalDetected);
         pros::lcd::print(5, "Left Motor Position (inches): %f", left_motors.get_position() * (lemlib::Omniwheel::NEW_275 * M_PI));
 
-        pros::delay(20);
+        pros::delay(POLL_RATE);
+    }
+
+    // Clamp goal
+    clamp.extend();
+}
+
+void AutoClamp::waitUntilClampPredictive(int maxDist, int maxTime) {
+    int startTime = pros::millis(); // Record the start time of the function
+    int goalDetected = 0; // Counter for consecutive goal detections
+    GoalPredictor predictor;
+
+    // Ensure clamp is up
+    clamp.retract();
+
+    // Set up motor for distance tracking
+    left_motors.tare_position(0);
+
+    // Convert maxDist from inches to rotations
+    double maxDistRotations = maxDist / (lemlib::Omniwheel::NEW_275 * M_PI);
+
+    // Loop until the clamp should fire, the goal is detected enough times, or it times out
+    while (pros::millis() - startTime < maxTime && goalDetected < MIN_DETECTION && left_motors.get_position(0) > -maxDistRotations) {
+        predictor.update();
+        if (predictor.shouldFire()) {
+            break;
+        }
+
+        // fall back on plain detection if the prediction never becomes confident
+        goalDetected = isDetected() ? goalDetected + 1 : 0;
+
+        pros::lcd::print(3, "Goal Range (inches): %f", predictor.getRange());
+        pros::lcd::print(4, "Closing Speed (in/s): %f", predictor.getClosingSpeed());
+        pros::lcd::print(5, "Time To Contact (ms): %f", predictor.getTimeToContact());
+        pros::lcd::print(6, "Confidence: %d", predictor.getConfidence());
+
+        pros::delay(SAMPLE_RATE);
     }
 
     // Clamp goal
@@ -66,6 +208,10 @@ bool AutoClamp::isEnabled() {
 }
 
 void AutoClamp::setActive(bool active) {
+    if (active && !device_health.isHealthy(goalSens.get_port())) {
+        pros::lcd::print(1, "WARN: Auto clamp blocked b/c goal sensor fault");
+        return;
+    }
     isActive = active;
 }
 
@@ -76,15 +222,27 @@ void AutoClamp::disable() {
     setActive(false);
 }
 
+// measures how late each clamp check wakes and how long it runs
+LoopTimer autoClampTimer("Auto Clamp", SAMPLE_RATE);
+
 void auto_clamp_task(void *param)
 {
     int goalDetected = 0; // Counter for consecutive goal detections
+    GoalPredictor predictor; // Fires the clamp ahead of contact when the robot is closing fast
 
     // Loop forever
     while (true)
     {
+        // Turn auto clamp off rather than fire on a broken goal sensor
+        if (auto_clamp.isEnabled() && !device_health.isHealthy(goalSens.get_port()))
+        {
+            auto_clamp.disable();
+            pros::lcd::print(1, "WARN: Auto clamp off, goal sensor fault");
+        }
+
         if(auto_clamp.isEnabled() && !clamp.is_extended())
         {
+            TRACE_ZONE("Auto Clamp");
 
             // Check if goal is detected
             bool detected = AutoClamp::isDetected();
@@ -103,20 +261,29 @@ void auto_clamp_task(void *param)
                 clamp.retract();
             }
 
-            // If goal is detected enough times and clamp is up
-            if (goalDetected >= Goal::MIN_DETECTION && !clamp.is_extended())
+            // If goal is detected enough times or predicted to touch within a stroke and clamp is up
+            predictor.update();
+            if ((goalDetected >= MIN_DETECTION || predictor.shouldFire()) && !clamp.is_extended())
             {
                 // Extend the clamp
                 clamp.extend();
             }
         }
+        else
+        {
+            // Start fresh the next time the clamp is armed
+            predictor.reset();
+        }
 
-        // Delay to save resources
-        pros::delay(20);
+        // Delay to save resources, fast enough to predict contact
+        autoClampTimer.delay();
         
     }
 }    
 
+// measures how much of the CPU reprinting the clamp screen takes
+LoopTimer autoClampScreenTimer("Auto Clamp Screen", 100);
+
 // Display all the information about the autoclamp mechanism on the LCD screen on lines 1-7
 void auto_clamp_screen_task(void *param) {
     while (true) {
@@ -124,6 +291,6 @@ void auto_clamp_screen_task(void *param) {
         pros::lcd::print(2, "Goal Clamped: %s", auto_clamp.isGoalClamped() ? "True" : "False");
         pros::lcd::print(3, "Auto Clamp Enabled: %s", auto_clamp.isEnabled() ? "True" : "False");
         pros::lcd::print(4, "Clamp State: %s", clamp.is_extended() ? "Extended" : "Retracted");
-        pros::delay(100);
+        autoClampScreenTimer.delay();
     }
 }
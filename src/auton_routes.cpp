@@ -62,7 +62,9 @@ void endSection(int delay)
         // updates controller screen with section information
         autonSection++;
         controller.clear_line(1);
-        controller.set_text(1, 1, std::to_string(autonSection).c_str());
+        char sectionText[12];
+        snprintf(sectionText, sizeof(sectionText), "%d", autonSection); // no std::string, this runs between motions
+        controller.set_text(1, 1, sectionText);
     }
 }
 
@@ -73,13 +75,15 @@ bool isRedTeam = competitionSelector.isRedTeam;
 
 void progSkills(){
     chassis.setPose(-58, 0, 270);
-    oc_motor.move(127);
+    power_manager.setMode(PowerMode::SCORING);
+    battery_monitor.move(oc_motor, 127);
     delay(500);
-    oc_motor.move(-127);
+    battery_monitor.move(oc_motor, -127);
     delay(100);
+    power_manager.setMode(PowerMode::BALANCED);
     clamp.set_value(LOW);
     drivePID(-9, 1000);
-    oc_motor.brake();
+    device_cache.brake(oc_motor);
     // endSection(50000);
     delay(300);
     chassis.turnToHeading(358, 2000);
@@ -88,7 +92,7 @@ void progSkills(){
     clamp.set_value(HIGH);
     delay(150);
     chassis.turnToHeading(90, 2000);
-    intake.move(127);
+    intake_controller.move(127);
     drivePID(25);
     delay(300);
     chassis.turnToHeading(125, 2000);
@@ -109,11 +113,11 @@ void progSkills(){
     drivePID(-16);
     chassis.turnToHeading(45, 2000);
     drivePID(-21,3000,25);
-    intake.move(-90);
+    intake_controller.move(-90);
     clamp.set_value(LOW);
     endSection(1000);
     drivePID(19);
-    intake.move(127);
+    intake_controller.move(127);
     chassis.turnToHeading(180, 2000);
     
     drivePID(-55,5000,35);
@@ -128,7 +132,7 @@ void progSkills(){
     drivePID(5, 600);
     endSection(500);
     chassis.turnToHeading(90, 2000);
-    intake.move(127);
+    intake_controller.move(127);
     drivePID(25);
     delay(300);
     chassis.turnToHeading(55, 2000);
@@ -149,11 +153,11 @@ void progSkills(){
     drivePID(-16);
     chassis.turnToHeading(135, 2000);
     drivePID(-23,3000,25);
-    intake.move(-90);
+    intake_controller.move(-90);
     clamp.set_value(LOW);
     endSection(1000);
     drivePID(25);
-    intake.move(127);
+    intake_controller.move(127);
 }
 
 
@@ -165,14 +169,13 @@ void ringRush(int mode){
         chassis.setPose(58, 48 - 3.5 - 13.5/2,90);
 
         // * Ring Rush
-        intake.move(127);
+        intake_controller.move(127);
+        chassis.atTime(800, []() { left_doinker.extend(); }); // extend
         chassis.moveToPoint(chassis.getPose().x + 50, chassis.getPose().y + 10, 2000, {.minSpeed=10});
-        delay(800);
-        left_doinker.extend(); // extend
         chassis.waitUntilDone();
         delay(500);
         //color_sort.waitUntilDetected(2000,RingColor::red);
-        intake.brake();
+        intake_controller.brake();
 
         // * Retreat
         chassis.moveToPoint(-33, 36, 1000, {.forwards=false}, false);
@@ -201,9 +204,9 @@ void ringRush(int mode){
 
         // * Safe
         chassis.turnToPoint(-24,48,1000,{},false);
-        intake.move(127);
+        intake_controller.move(127);
         chassis.moveToPoint(-24,56,2000,{.maxSpeed=50},false);
-        intake.brake();
+        intake_controller.brake();
         // TODO: STOP IF BLUE INTAKED
 
         // * Corner
@@ -212,7 +215,7 @@ void ringRush(int mode){
         while(chassis.isInMotion() && chassis.getPose().distance(corner) > 6){
             delay(20);
         }
-        intake.move(127);
+        intake_controller.move(127);
         chassis.waitUntilDone();
         
         // * Reset
@@ -238,18 +241,17 @@ void ringRush(int mode){
 
         // * Alliance
         Pose alliance(-47,0,0);
+        int allianceZone = geofence.addCircle(alliance.x,alliance.y,6,[]() { redirect.extend(); },nullptr,true);
         chassis.moveToPoint(alliance.x,alliance.y,1000,{.minSpeed=20,.earlyExitRange=5});
-        while(chassis.isInMotion() && chassis.getPose().distance(alliance) > 6){
-            delay(20);
-        }
-        redirect.extend();
         chassis.waitUntilDone();
+        geofence.remove(allianceZone);
+        redirect.extend(); // in case the motion exited before reaching the zone
         chassis.moveToPoint(alliance.x,alliance.y-10, 1000,{.maxSpeed=40,.minSpeed=40,.earlyExitRange=5});
 
         //color_sort.waitUntilDetected(1000);
         //redirect.retract();
         chassis.waitUntilDone();
-        intake.brake();
+        intake_controller.brake();
 
         // This is where the route splits into different modes
         // depending on alliances and strategies
@@ -287,7 +289,9 @@ void redGoalSideSugarRush(int i)
     clamp.set_value(LOW);
     right_doinker.set_value(HIGH);
     chassis.setPose(0, 0, 90);
+    power_manager.setMode(PowerMode::DRIVE_PRIORITY); // give the rush all the current it can take
     drivePID(40, 1000, 70);
+    power_manager.setMode(PowerMode::BALANCED);
     endSection();
 
     chassis.turnToHeading(275, 1000, {}, false);
@@ -295,10 +299,10 @@ void redGoalSideSugarRush(int i)
     endSection();
 
     chassis.turnToHeading(320, 1000);
-    intake.move(127);
+    intake_controller.move(127);
     drivePID(15);
     delay(270);
-    intake.brake();
+    intake_controller.brake();
     //drivePID(8);
     endSection(100);
 
@@ -308,7 +312,7 @@ void redGoalSideSugarRush(int i)
     endSection(500);
 
     chassis.turnToHeading(270, 1000, {}, false);
-    intake.move(127);
+    intake_controller.move(127);
     drivePID(35, 1000);
     endSection();
 
@@ -320,7 +324,7 @@ void redGoalSideSugarRush(int i)
     chassis.turnToHeading(90, 1000, {}, false);
     endSection();
 
-    intake.brake();
+    intake_controller.brake();
     drivePID(20, 1000);
     clamp.set_value(LOW);
     endSection();
@@ -337,7 +341,9 @@ void blueGoalSideSugarRush(int i)
     clamp.set_value(LOW);
     left_doinker.set_value(HIGH);
     chassis.setPose(0, 0, -90);
+    power_manager.setMode(PowerMode::DRIVE_PRIORITY); // give the rush all the current it can take
     drivePID(40, 1000, 70);
+    power_manager.setMode(PowerMode::BALANCED);
     endSection();
 
     chassis.turnToHeading(-275, 1000, {}, false);
@@ -345,10 +351,10 @@ void blueGoalSideSugarRush(int i)
     endSection();
 
     chassis.turnToHeading(-320, 1000);
-    intake.move(127);
+    intake_controller.move(127);
     drivePID(15);
     delay(270);
-    intake.brake();
+    intake_controller.brake();
     //drivePID(8);
     endSection(100);
 
@@ -358,7 +364,7 @@ void blueGoalSideSugarRush(int i)
     endSection(500);
 
     chassis.turnToHeading(-270, 1000, {}, false);
-    intake.move(127);
+    intake_controller.move(127);
     drivePID(35, 1000);
     endSection();
 
@@ -370,7 +376,7 @@ void blueGoalSideSugarRush(int i)
     chassis.turnToHeading(-90, 1000, {}, false);
     endSection();
 
-    intake.brake();
+    intake_controller.brake();
     drivePID(20, 1000);
     clamp.set_value(LOW);
     endSection();
@@ -399,30 +405,27 @@ void blueGoalSideSugarRush(int i)
 
             // move to alliance ring and score it
             chassis.turnToHeading(159, 1000, {}, false);
-            intake.move(80);
+            intake_controller.move(80);
             drivePID(27, 1000, 45);
             //setArmBottom();
             delay(150);
-            intake.move(20);
+            intake_controller.move(20);
             // chassis.turnToHeading(180 ,1000,{},false);
 
             drivePID(-15, 1000);
             delay(500);
-            intake.brake();
+            intake_controller.brake();
             chassis.turnToHeading(252, 700, {}, false);
-            intake.brake();
+            intake_controller.brake();
 
             // go to goal and clamp
             drivePID(-18, 1500);
             drivePID(-10, 1000, 42.5);
             clamp.set_value(LOW);
-            waitUntilAnyIntake(300);
-            intake.move(127);
+            ring_tracker.waitForRing(300);
+            intake_controller.move(127);
             endSection(500);
             chassis.turnToHeading(20, 1000, {}, false);
-            intake.move(-50);
-            delay(100);
-            intake.move(127);
 
             // score ring 2
             drivePID(29, 1000, 45);
@@ -431,8 +434,8 @@ void blueGoalSideSugarRush(int i)
             // go to middle
             chassis.turnToHeading(165, 1000, {}, false);
             //setArmMid();
-            left_motors.move(42);
-            right_motors.move(42);
+            battery_monitor.move(left_motors, 42);
+            battery_monitor.move(right_motors, 42);
             delay(5000);
             left_motors.brake();
             right_motors.brake();
@@ -452,30 +455,27 @@ void blueGoalSideSugarRush(int i)
 
             // move to alliance ring and score it
             chassis.turnToHeading(-159, 1000, {}, false);
-            intake.move(80);
+            intake_controller.move(80);
             drivePID(27, 1000, 45);
             //setArmBottom();
             delay(150);
-            intake.move(20);
+            intake_controller.move(20);
             // chassis.turnToHeading(180 ,1000,{},false);
 
             drivePID(-15, 1000);
             delay(500);
-            intake.brake();
+            intake_controller.brake();
             chassis.turnToHeading(-252, 700, {}, false);
-            intake.brake();
+            intake_controller.brake();
 
             // go to goal and clamp
             drivePID(-18, 1500);
             drivePID(-10, 1000, 42.5);
             clamp.set_value(LOW);
-            waitUntilAnyIntake(300);
-            intake.move(127);
+            ring_tracker.waitForRing(300);
+            intake_controller.move(127);
             endSection(500);
             chassis.turnToHeading(-20, 1000, {}, false);
-            intake.move(-50);
-            delay(100);
-            intake.move(127);
 
             // score ring 2
             drivePID(29, 1000, 45);
@@ -484,8 +484,8 @@ void blueGoalSideSugarRush(int i)
             // go to middle
             chassis.turnToHeading(-165, 1000, {}, false);
             //setArmMid();
-            left_motors.move(42);
-            right_motors.move(42);
+            battery_monitor.move(left_motors, 42);
+            battery_monitor.move(right_motors, 42);
             delay(5000);
             left_motors.brake();
             right_motors.brake();
@@ -496,24 +496,26 @@ void safeAWP(int mode){
     if(mode == -1){
         // * LEFT SIDE
         // todo: fix the brake types
-        all_motors.set_brake_mode_all(E_MOTOR_BRAKE_HOLD);
+        device_cache.setBrakeMode(all_motors, E_MOTOR_BRAKE_HOLD);
 
         // push middle ring
-        intake.move(-127);
+        intake_controller.move(-127);
         chassis.setPose(0, 0, 0);
         drivePID(12,800);
         
         // face and score ring on alliance stake
         chassis.turnToHeading(90, 1000, {}, false);
         drivePID(2,500);
-        oc_motor.move(127);
+        power_manager.setMode(PowerMode::SCORING);
+        battery_monitor.move(oc_motor, 127);
         delay(500);
-        oc_motor.move(-127);
+        battery_monitor.move(oc_motor, -127);
         delay(100);
+        power_manager.setMode(PowerMode::BALANCED);
         drivePID(-12,800);
-        oc_motor.brake();
+        device_cache.brake(oc_motor);
         // todo: fix the brake types
-        all_motors.set_brake_mode_all(E_MOTOR_BRAKE_COAST);
+        device_cache.setBrakeMode(all_motors, E_MOTOR_BRAKE_COAST);
         drivePID(3,500);
 
         // turn and clamp
@@ -523,7 +525,7 @@ void safeAWP(int mode){
 
         // turn and score ring on mogo
         chassis.turnToHeading(180, 1000, {}, false);
-        intake.move(127);
+        intake_controller.move(127);
         drivePID(30,2000,30);
 
         // turn to mid and touch
@@ -534,24 +536,26 @@ void safeAWP(int mode){
     else{
         // * RIGHT SIDE
         // todo: fix the brake types
-        all_motors.set_brake_mode_all(E_MOTOR_BRAKE_HOLD);
+        device_cache.setBrakeMode(all_motors, E_MOTOR_BRAKE_HOLD);
 
         // push middle ring
-        intake.move(-127);
+        intake_controller.move(-127);
         chassis.setPose(0, 0, 0);
         drivePID(12,800);
         
         // face and score ring on alliance stake
         chassis.turnToHeading(-90, 1000, {}, false);
         drivePID(2,500);
-        oc_motor.move(127);
+        power_manager.setMode(PowerMode::SCORING);
+        battery_monitor.move(oc_motor, 127);
         delay(500);
-        oc_motor.move(-127);
+        battery_monitor.move(oc_motor, -127);
         delay(100);
+        power_manager.setMode(PowerMode::BALANCED);
         drivePID(-12,800);
-        oc_motor.brake();
+        device_cache.brake(oc_motor);
         // todo: fix the brake types
-        all_motors.set_brake_mode_all(E_MOTOR_BRAKE_COAST);
+        device_cache.setBrakeMode(all_motors, E_MOTOR_BRAKE_COAST);
         drivePID(3,500);
 
         // turn and clamp
@@ -561,7 +565,7 @@ void safeAWP(int mode){
 
         // turn and score ring on mogo
         chassis.turnToHeading(-180, 1000, {}, false);
-        intake.move(127);
+        intake_controller.move(127);
         drivePID(30,2000,30);
 
         // turn to mid and touch
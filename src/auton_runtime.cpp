@@ -0,0 +1,256 @@
+#include "auton_runtime.h"
+#include "lemlib/api.hpp" // IWYU pragma: keep
+#include <cstdlib>
+#include <exception>
+#include "devices.h"
+
+namespace RuntimeConfig {
+    const int TICK_RATE = 5;
+}
+
+// Fixed pool of coroutine frames so branches never allocate from the heap
+alignas(std::max_align_t) static unsigned char framePool[RuntimeConfig::MAX_BRANCHES][RuntimeConfig::FRAME_SIZE];
+static bool frameUsed[RuntimeConfig::MAX_BRANCHES] = {};
+static pros::Mutex frameMutex;
+
+void* AutonTask::promise_type::operator new(std::size_t size) noexcept {
+    if (size > RuntimeConfig::FRAME_SIZE) {
+        pros::lcd::print(1, "WARN: Auton task frame is %d bytes, max is %d", size, RuntimeConfig::FRAME_SIZE);
+        return nullptr;
+    }
+
+    std::lock_guard<pros::Mutex> lock(frameMutex);
+    for (int i = 0; i < RuntimeConfig::MAX_BRANCHES; i++) {
+        if (!frameUsed[i]) {
+            frameUsed[i] = true;
+            return framePool[i];
+        }
+    }
+
+    pros::lcd::print(1, "WARN: Auton task dropped b/c frame pool is full");
+    return nullptr;
+}
+
+void AutonTask::promise_type::operator delete(void* ptr) noexcept {
+    std::lock_guard<pros::Mutex> lock(frameMutex);
+    for (int i = 0; i < RuntimeConfig::MAX_BRANCHES; i++) {
+        if (ptr == framePool[i]) {
+            frameUsed[i] = false;
+            return;
+        }
+    }
+}
+
+AutonTask AutonTask::promise_type::get_return_object_on_allocation_failure() {
+    return AutonTask(nullptr);
+}
+
+AutonTask AutonTask::promise_type::get_return_object() {
+    return AutonTask(Handle::from_promise(*this));
+}
+
+void AutonTask::promise_type::unhandled_exception() {
+    // a throwing branch would leave mechanisms in an unknown state, so stop everything
+    std::terminate();
+}
+
+AutonTask::AutonTask(Handle handle) : handle(handle) {}
+
+AutonTask::AutonTask(AutonTask&& other) noexcept : handle(other.release()) {}
+
+AutonTask& AutonTask::operator=(AutonTask&& other) noexcept {
+    if (this != &other) {
+        if (handle) handle.destroy();
+        handle = other.release();
+    }
+    return *this;
+}
+
+AutonTask::~AutonTask() {
+    // a task that was never spawned still owns its frame
+    if (handle) handle.destroy();
+}
+
+AutonTask::Handle AutonTask::release() {
+    Handle released = handle;
+    handle = nullptr;
+    return released;
+}
+
+namespace Await {
+    bool TimeAwaiter::ready() {
+        return (int)pros::millis() >= wakeTime;
+    }
+
+    bool UntilAwaiter::ready() {
+        met = condition();
+        return met || (int)pros::millis() >= timeoutTime;
+    }
+
+    bool MotionAwaiter::ready() {
+        return !chassis.isInMotion();
+    }
+
+    TimeAwaiter time(int msec) {
+        TimeAwaiter awaiter;
+        awaiter.wakeTime = pros::millis() + msec;
+        return awaiter;
+    }
+
+    UntilAwaiter until(bool (*condition)(), int msecTimeout) {
+        UntilAwaiter awaiter;
+        awaiter.condition = condition;
+        awaiter.timeoutTime = pros::millis() + msecTimeout;
+        return awaiter;
+    }
+
+    MotionAwaiter motion() {
+        return MotionAwaiter();
+    }
+}
+
+bool AutonRuntime::JoinAwaiter::ready() {
+    return runtime->isDone(branch);
+}
+
+Branch AutonRuntime::spawn(AutonTask task) {
+    Branch branch;
+    AutonTask::Handle handle = task.release();
+    if (!handle) {
+        return branch;
+    }
+
+    std::lock_guard<pros::Mutex> lock(mutex);
+    // nothing has used branches yet, start resuming them now
+    if (runtimeTask == nullptr) {
+        runtimeTask = pros::c::task_create(auton_runtime_task, nullptr, TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT,
+                                           "Auton Runtime Task");
+    }
+    for (int i = 0; i < RuntimeConfig::MAX_BRANCHES; i++) {
+        if (slots[i].state == SlotState::EMPTY) {
+            slots[i].handle = handle;
+            slots[i].state = SlotState::RUNNING;
+            branch.slot = i;
+            branch.generation = slots[i].generation;
+            return branch;
+        }
+    }
+
+    // frames and slots are the same size, so this only happens if a task was created but never spawned
+    pros::lcd::print(1, "WARN: Auton branch dropped b/c all slots are full");
+    handle.destroy();
+    return branch;
+}
+
+void AutonRuntime::run(AutonTask task) {
+    Branch branch = spawn(std::move(task));
+    while (!isDone(branch)) {
+        pros::delay(RuntimeConfig::TICK_RATE);
+    }
+}
+
+AutonRuntime::JoinAwaiter AutonRuntime::join(Branch branch) {
+    JoinAwaiter awaiter;
+    awaiter.runtime = this;
+    awaiter.branch = branch;
+    return awaiter;
+}
+
+bool AutonRuntime::isDone(Branch branch) {
+    if (branch.slot < 0) {
+        return true;
+    }
+
+    std::lock_guard<pros::Mutex> lock(mutex);
+    const Slot& slot = slots[branch.slot];
+    return slot.generation != branch.generation || slot.state != SlotState::RUNNING;
+}
+
+bool AutonRuntime::waitUntilDone(Branch branch, int msecTimeout) {
+    int startTime = pros::millis(); // Record the start time of the function
+    while (!isDone(branch)) {
+        if ((int)pros::millis() - startTime >= msecTimeout) {
+            return false;
+        }
+        pros::delay(RuntimeConfig::TICK_RATE);
+    }
+    return true;
+}
+
+void AutonRuntime::cancel(Branch branch) {
+    if (branch.slot < 0) {
+        return;
+    }
+
+    std::lock_guard<pros::Mutex> lock(mutex);
+    Slot& slot = slots[branch.slot];
+    if (slot.generation == branch.generation && slot.state == SlotState::RUNNING) {
+        slot.state = SlotState::CANCELED;
+    }
+}
+
+void AutonRuntime::cancelAll() {
+    std::lock_guard<pros::Mutex> lock(mutex);
+    for (Slot& slot : slots) {
+        if (slot.state == SlotState::RUNNING) {
+            slot.state = SlotState::CANCELED;
+        }
+    }
+}
+
+int AutonRuntime::getBranchCount() {
+    std::lock_guard<pros::Mutex> lock(mutex);
+    int count = 0;
+    for (const Slot& slot : slots) {
+        if (slot.state == SlotState::RUNNING) count++;
+    }
+    return count;
+}
+
+void AutonRuntime::tick() {
+    for (int i = 0; i < RuntimeConfig::MAX_BRANCHES; i++) {
+        AutonTask::Handle handle;
+        {
+            std::lock_guard<pros::Mutex> lock(mutex);
+            Slot& slot = slots[i];
+            if (slot.state == SlotState::EMPTY) continue;
+
+            // frames are only ever destroyed here, so a branch is never destroyed while it runs
+            if (slot.state == SlotState::CANCELED) {
+                slot.handle.destroy();
+                slot.handle = nullptr;
+                slot.state = SlotState::EMPTY;
+                slot.generation++;
+                continue;
+            }
+            handle = slot.handle;
+        }
+
+        // resume outside of the lock so branches can spawn and join other branches
+        AutonTask::promise_type& promise = handle.promise();
+        if (promise.waiter != nullptr && !promise.waiter->ready()) continue;
+        promise.waiter = nullptr;
+        handle.resume();
+
+        if (handle.done()) {
+            std::lock_guard<pros::Mutex> lock(mutex);
+            handle.destroy();
+            slots[i].handle = nullptr;
+            slots[i].state = SlotState::EMPTY;
+            slots[i].generation++;
+        }
+    }
+}
+
+// measures how late each runtime tick wakes and how long it runs
+LoopTimer autonRuntimeTimer("Auton Runtime", RuntimeConfig::TICK_RATE);
+
+// Task that resumes autonomous coroutines when what they are waiting on is ready
+void auton_runtime_task(void *param) {
+    while (true) {
+        auton_runtime.tick();
+
+        // Delay to save resources
+        autonRuntimeTimer.delay();
+    }
+}
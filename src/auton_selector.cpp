@@ -1,6 +1,9 @@
 #include "auton_selector.h"
 #include "auton_routes.h"
 #include "testing.h"
+#include "pid_tuner.h"
+#include "sysid.h"
+#include "ring_classifier.h"
 #include "devices.h"
 #include "main.h"
 #include <variant>
@@ -71,20 +74,49 @@ bool AutonSelector::setSelection(int newSelection) {
     }
 }
 
-void AutonSelector::runSelection() {
+// Does everything runSelection would before the first motor command, so it can be done while disabled
+void AutonSelector::prewarm() {
     if (currentSelection < 0 || currentSelection >= routines.size()) {
-        pros::lcd::clear_line(4);
-        pros::lcd::print(4, "Invalid selection: %d", currentSelection);
+        prewarmedRoutine = nullptr;
+        prewarmedSelection = -1;
         return;
     }
 
+    // bind the parameter now so starting the routine is a single call
     const AutonRoutine& selectedRoutine = routines[currentSelection];
-
     if (auto func = std::get_if<std::function<void()>>(&selectedRoutine.func)) {
-        (*func)();
+        prewarmedRoutine = *func;
     } else if (auto func = std::get_if<std::function<void(int)>>(&selectedRoutine.func)) {
-        (*func)(selectedRoutine.parameter);
+        int parameter = selectedRoutine.parameter;
+        prewarmedRoutine = [func = *func, parameter]() { func(parameter); };
     }
+    prewarmedSelection = currentSelection;
+
+    // stage the robot the way every route expects to start
+    device_cache.setBrakeMode(all_motors, E_MOTOR_BRAKE_HOLD);
+    clamp.retract();
+    oc_piston.retract();
+    power_manager.setMode(PowerMode::BALANCED);
+}
+
+void AutonSelector::runSelection() {
+    if (currentSelection < 0 || currentSelection >= routines.size()) {
+        pros::lcd::clear_line(4);
+        pros::lcd::print(4, "Invalid selection: %d", currentSelection);
+        return;
+    }
+
+    // the selector buttons prewarm in competition, this only runs when auton is started some other way
+    if (prewarmedSelection != currentSelection) {
+        prewarm();
+    }
+    if (prewarmedRoutine) {
+        TRACE_ZONE("Route");
+        prewarmedRoutine();
+    }
+
+    // autonomous undoes the staging when it finishes, so a rerun after a field reset has to stage again
+    prewarmedSelection = -1;
 }
 
 int AutonSelector::getRoutineCount() const {
@@ -105,7 +137,10 @@ const AutonRoutine COMPETITION_ROUTINES[] = {
 };
 
 const AutonRoutine TESTING_ROUTINES[] = {
-    {"Test Ring Sensor", testRingSens}
+    {"Test Ring Sensor", testRingSens},
+    {"Autotune PID", autotunePID},
+    {"Sysid", runSysid},
+    {"Record Ring Samples", recordRingSamples}
 };
 
 const bool isTestingCombined = false;
@@ -116,6 +151,7 @@ AutonSelector testingSelector(TESTING_ROUTINES, sizeof(TESTING_ROUTINES) / sizeo
 void on_left_button() {
     competitionSelector.prevSelection();
     competitionSelector.displaySelectionBrain();
+    competitionSelector.prewarm();
 }
 
 void on_center_button() {
@@ -125,4 +161,5 @@ void on_center_button() {
 void on_right_button() {
     competitionSelector.nextSelection();
     competitionSelector.displaySelectionBrain();
+    competitionSelector.prewarm();
 }
\ No newline at end of file
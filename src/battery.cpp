@@ -0,0 +1,54 @@
+#include "battery.h"
+#include "lemlib/api.hpp" // IWYU pragma: keep
+#include <cstdlib>
+#include "devices.h"
+
+namespace BatteryConfig {
+    const double NOMINAL_VOLTAGE = 11500; // a little under a full battery so there is headroom to scale up
+    const int SAMPLE_RATE = 10;
+    const double FILTER_WEIGHT = 0.1; // about 100 ms time constant at the sample rate
+    const double MIN_VALID_VOLTAGE = 6000;
+}
+
+const double MAX_VOLTAGE = 12000; // largest voltage a motor accepts, in mV
+
+void BatteryMonitor::update() {
+    double reading = pros::battery::get_voltage();
+    if (reading < BatteryConfig::MIN_VALID_VOLTAGE) {
+        return;
+    }
+
+    std::lock_guard<pros::Mutex> lock(mutex);
+    voltage = voltage == 0 ? reading : lemlib::ema(reading, voltage, BatteryConfig::FILTER_WEIGHT);
+}
+
+double BatteryMonitor::getVoltage() {
+    std::lock_guard<pros::Mutex> lock(mutex);
+    return voltage == 0 ? BatteryConfig::NOMINAL_VOLTAGE : voltage;
+}
+
+double BatteryMonitor::getScale() {
+    return BatteryConfig::NOMINAL_VOLTAGE / getVoltage();
+}
+
+int BatteryMonitor::compensate(double power) {
+    double requested = power / 127 * MAX_VOLTAGE * getScale();
+    return std::clamp(requested, -MAX_VOLTAGE, MAX_VOLTAGE);
+}
+
+void BatteryMonitor::move(pros::AbstractMotor& motor, double power) {
+    device_cache.moveVoltage(motor, compensate(power));
+}
+
+// measures how late each battery sample wakes and how long it runs
+LoopTimer batteryTimer("Battery", BatteryConfig::SAMPLE_RATE);
+
+// Task that keeps the filtered battery voltage up to date
+void battery_task(void *param) {
+    while (true) {
+        battery_monitor.update();
+
+        // Delay to save resources
+        batteryTimer.delay();
+    }
+}
@@ -29,46 +29,17 @@ bool waitUntilRingDetected(int msecTimeout, int targetHue)
     int startTime = pros::millis(); // Record the start time of the function
     int ringDetected = 0;           // Counter for consecutive ring detections
 
-    // Define acceptable hue range based on the desired ring color
-    int hueMin, hueMax;
-
-    // set target hue to correct team
-    if (targetHue == -1)
-    {
-        // detecting any hue if no team is specified
-        hueMin = 0;
-        hueMax = 360;
-    }
-    else
-    {
-        // detecting specific hue
-        hueMin = (targetHue - HUE_RANGE + 360) % 360; // Wrap around to ensure valid range
-        hueMax = (targetHue + HUE_RANGE) % 360;       // Wrap around to ensure valid range
-    }
-
     ringSens.set_led_pwm(100); // Set the LED brightness to maximum for better detection
 
     while (pros::millis() - startTime < msecTimeout && ringDetected < MIN_RING_DETECTION)
     {
         // Calculate elapsed time and check if detection target is met
 
-        int currentHue = ringSens.get_hue();        // Get the current hue value from the sensor
-        int currentDist = ringSens.get_proximity(); // Get the current proximity value from the sensor
-
-        // Determine if the current hue falls within the valid range, considering wrapping around 360 degrees
-
-        bool inHueRange;
-        if (targetHue == -1)
-        {
-            inHueRange = true;
-        }
-        else
-        {
-            inHueRange = (hueMin <= hueMax) ? (currentHue >= hueMin && currentHue <= hueMax) : (currentHue >= hueMin || currentHue <= hueMax);
-        }
-
-        bool inDist = currentDist > 255 - MAX_RING_DISTANCE;
-        if ((inHueRange || targetHue == -1) && inDist)
+        // one lookup table sample is confident enough on its own, no hue band or proximity check needed
+        RingClass ringClass = ring_classifier.sample();
+        RingClass targetClass = targetHue == RED_RING_HUE ? RingClass::RED : RingClass::BLUE;
+        bool matches = targetHue == -1 ? ringClass != RingClass::EMPTY : ringClass == targetClass;
+        if (matches)
         {
             // Increment the detection counter if the conditions are met
             ringDetected++;
@@ -169,21 +140,22 @@ int ColorSort::getLastDetection(Hue hue) const {
     return hue.getLastDetection();
 }
 bool ColorSort::isDetected(Hue hue) {
+    // Classify a single sample with the lookup table
+    RingClass ringClass = ring_classifier.sample();
 
+    bool detected;
+    if (hue.equals(RingColor::any)) {
+        detected = ringClass != RingClass::EMPTY;
+    }
+    else {
+        detected = ringClass == (hue.equals(RingColor::red) ? RingClass::RED : RingClass::BLUE);
+    }
 
-    double currentHue = ringSens.get_hue(); // Get the current hue value from the sensor
-    int currentDist = ringSens.get_proximity(); // Get the current proximity value from the sensor
-
-    // Determine if the current hue falls within the valid range, considering wrapping around 360 degrees
-    bool inHueRange = hue.inRange(currentHue);
-
-    bool detected = inHueRange && currentDist < RingConfig::MAX_RING_DISTANCE;
-
-    // Update the detection timestamps
+    // Update the detection timestamps with the color that was actually seen
     if (detected) {
         int detectionTime = pros::millis();
         RingColor::any.setLastDetection(detectionTime);
-        if(hue.equals(RingColor::red)) {
+        if(ringClass == RingClass::RED) {
             RingColor::red.setLastDetection(detectionTime);
         } 
         else {
@@ -228,6 +200,9 @@ void ColorSort::setActive(bool active) {
     if(autoRedirectHue.equals(RingColor::any) && active != isEnabled()) {
         pros::lcd::print(1, "WARN: AutoRedirect toggle blocked b/c color not set");
     }
+    else if(active && !device_health.isHealthy(ringSens.get_port())) {
+        pros::lcd::print(1, "WARN: AutoRedirect blocked b/c ring sensor fault");
+    }
     else {
         isActive = active;
     }
@@ -265,11 +240,23 @@ bool ColorSort::isEnabled() {
     return isActive;
 }
 
+// measures how late each color sort cycle wakes and how long it runs
+LoopTimer colorSortTimer("Color Sort", 20);
+
 // Task for controlling the color sorter
 void color_sort_task(void *param) {
+    std::uint32_t wake = pros::millis();
     while (true) {
+        // Turn color sort off rather than misfire the redirect on a broken ring sensor
+        if (color_sort.isEnabled() && !device_health.isHealthy(ringSens.get_port())) {
+            color_sort.disable();
+            pros::lcd::print(1, "WARN: Color sort off, ring sensor fault");
+        }
+
         // Check if the color sorter is enabled
         if (color_sort.isEnabled()) {
+            TRACE_ZONE("Color Sort");
+            colorSortTimer.recordAge(device_timing.getAge(DataSource::RING_SENSOR));
             // Check if the detected color matches the auto-redirect hue
             if (color_sort.isDetected(color_sort.getRedirectHue())) {
                 // Extend the redirect mechanism if the redirect hue is detected
@@ -281,11 +268,15 @@ void color_sort_task(void *param) {
                 redirect.retract();
             }
         }
-        // Wait briefly before the next iteration to prevent excessive polling
-        pros::delay(20);
+        // Wait until just after the ring sensor has a new reading
+        wake = device_timing.nextWake(DataSource::RING_SENSOR, wake, 20);
+        colorSortTimer.delayUntil(wake);
     }
 }
 
+// measures how much of the CPU reprinting the color sort screen takes
+LoopTimer colorSortScreenTimer("Color Sort Screen", 100);
+
 // Display all the information about the colorsort mechanism on the LCD screen on lines 1-7
 void color_sort_screen_task(void *param) {
     while (true) {
@@ -296,6 +287,6 @@ void color_sort_screen_task(void *param) {
         pros::lcd::print(5, "Current Proximity: %d", ringSens.get_proximity());
         pros::lcd::print(6, "Last Detection: %d", color_sort.getLastDetection(RingColor::any));
         pros::lcd::print(7, "Last Red Detection: %d", color_sort.getLastDetection(RingColor::red));
-        pros::delay(100);
+        colorSortScreenTimer.delay();
     }
 }
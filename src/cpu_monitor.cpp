@@ -0,0 +1,186 @@
+#include "cpu_monitor.h"
+#include "lemlib/api.hpp" // IWYU pragma: keep
+#include <cstdlib>
+#include <cstring>
+#include "devices.h"
+
+namespace CpuConfig {
+    const int SAMPLE_RATE = 1000;
+    const double LOOP_WARN = 10; // no loop here needs more than a few percent
+    const int PROBE_SLICE = 9700; // not a whole number of ticks so the probe doesn't lock to the 10 and 20 ms loops
+    const int PROBE_GAP = 20; // a clock read takes well under this
+}
+
+double CpuMonitor::share(const std::uint32_t* run, int windows) const {
+    windows = std::min(windows, filled);
+    double used = 0, length = 0;
+    for (int i = 1; i <= windows; i++) {
+        int index = (head - i + CpuConfig::WINDOWS) % CpuConfig::WINDOWS;
+        used += run[index];
+        length += windowLength[index];
+    }
+    return length == 0 ? -1 : used / length * 100;
+}
+
+double CpuMonitor::totalShare(int windows) const {
+    if (lastSeen == 0) {
+        return -1; // the probe hasn't run
+    }
+    windows = std::min(windows, filled);
+    double busy = 0, seen = 0;
+    for (int i = 1; i <= windows; i++) {
+        int index = (head - i + CpuConfig::WINDOWS) % CpuConfig::WINDOWS;
+        busy += windowBusy[index];
+        seen += windowSeen[index];
+    }
+    // the probe never finishing a slice means nothing left it any time
+    return seen == 0 ? 100 : busy / seen * 100;
+}
+
+void CpuMonitor::update() {
+    // read every counter first so the window is the same length for all of them
+    std::uint32_t now = pros::micros();
+    std::uint32_t busy = probeBusy.load(std::memory_order_relaxed);
+    std::uint32_t seen = probeSeen.load(std::memory_order_relaxed);
+    std::uint32_t runTimes[LoopTimerConfig::MAX_TIMERS];
+    int count = getLoopTimerCount();
+    for (int i = 0; i < count; i++) {
+        LoopTimer* timer = getLoopTimer(i);
+        if (timer == nullptr) {
+            count = i; // still registering, pick it up next window
+            break;
+        }
+        runTimes[i] = timer->getRunTime();
+    }
+
+    // warnings are printed after unlocking
+    const char* hotLoop = nullptr;
+    double hotLoad = 0;
+    {
+        std::lock_guard<pros::Mutex> lock(mutex);
+        if (lastSample != 0) {
+            windowLength[head] = now - lastSample;
+            windowBusy[head] = busy - lastBusy;
+            windowSeen[head] = seen - lastSeen;
+            for (int i = 0; i < count; i++) {
+                // counters wrap, unsigned differences stay right across the wrap
+                loopRun[i][head] = i < loops ? runTimes[i] - lastRunTime[i] : 0;
+            }
+            head = (head + 1) % CpuConfig::WINDOWS;
+            filled = std::min(filled + 1, CpuConfig::WINDOWS);
+
+            for (int i = 0; i < count; i++) {
+                peak[i] = std::max(peak[i], share(loopRun[i], 1));
+                double load = share(loopRun[i], CpuConfig::WINDOWS);
+                if (filled == CpuConfig::WINDOWS && load > CpuConfig::LOOP_WARN && !warned[i]) {
+                    warned[i] = true;
+                    hotLoop = getLoopTimer(i)->getName();
+                    hotLoad = load;
+                }
+            }
+        }
+        for (int i = 0; i < count; i++) {
+            lastRunTime[i] = runTimes[i];
+        }
+        loops = count;
+        lastSample = now;
+        lastBusy = busy;
+        lastSeen = seen;
+    }
+
+    if (hotLoop != nullptr) {
+        pros::lcd::print(1, "WARN: %s loop uses %.0f%% of the CPU", hotLoop, hotLoad);
+    }
+}
+
+void CpuMonitor::runProbe() {
+    while (true) {
+        std::uint32_t start = pros::micros();
+        std::uint32_t last = start;
+        std::uint32_t busy = 0;
+        while (last - start < static_cast<std::uint32_t>(CpuConfig::PROBE_SLICE)) {
+            std::uint32_t now = pros::micros();
+            // a long gap between two reads is time something else had the CPU
+            if (now - last > static_cast<std::uint32_t>(CpuConfig::PROBE_GAP)) {
+                busy += now - last;
+            }
+            last = now;
+        }
+        // only this task writes, the atomics just keep update from seeing torn values
+        probeBusy.store(probeBusy.load(std::memory_order_relaxed) + busy, std::memory_order_relaxed);
+        probeSeen.store(probeSeen.load(std::memory_order_relaxed) + (last - start), std::memory_order_relaxed);
+
+        // sleep a tick so the idle task gets to free deleted tasks
+        pros::delay(1);
+    }
+}
+
+double CpuMonitor::getLoopLoad(const char* name, int windows) {
+    std::lock_guard<pros::Mutex> lock(mutex);
+    for (int i = 0; i < loops; i++) {
+        if (strcmp(getLoopTimer(i)->getName(), name) == 0) {
+            return share(loopRun[i], windows);
+        }
+    }
+    return -1;
+}
+
+double CpuMonitor::getTotalLoad(int windows) {
+    std::lock_guard<pros::Mutex> lock(mutex);
+    return totalShare(windows);
+}
+
+void CpuMonitor::printTelemetry(int line) {
+    const char* busiest = "-";
+    double busiestLoad = 0, loopLoad = 0, total;
+    {
+        std::lock_guard<pros::Mutex> lock(mutex);
+        for (int i = 0; i < loops; i++) {
+            double load = std::max(share(loopRun[i], CpuConfig::WINDOWS), 0.0);
+            loopLoad += load;
+            if (load > busiestLoad) {
+                busiest = getLoopTimer(i)->getName();
+                busiestLoad = load;
+            }
+        }
+        total = totalShare(CpuConfig::WINDOWS);
+    }
+    pros::lcd::print(line, "CPU %.0f%%  TOP %s %.1f%%  OTHER %.0f%%", std::max(total, 0.0), busiest, busiestLoad,
+                     std::max(total - loopLoad, 0.0));
+}
+
+void CpuMonitor::printReport(FILE* out) {
+    std::lock_guard<pros::Mutex> lock(mutex);
+    fprintf(out, "%-20s | %6s | %6s | %6s\n", "loop", "1 s %", "10 s %", "peak %");
+    double recentLoad = 0, loopLoad = 0;
+    for (int i = 0; i < loops; i++) {
+        double recent = share(loopRun[i], 1);
+        double load = share(loopRun[i], CpuConfig::WINDOWS);
+        recentLoad += std::max(recent, 0.0);
+        loopLoad += std::max(load, 0.0);
+        fprintf(out, "%-20s | %6.2f | %6.2f | %6.2f\n", getLoopTimer(i)->getName(), recent, load, peak[i]);
+    }
+    double recentTotal = totalShare(1);
+    double total = totalShare(CpuConfig::WINDOWS);
+    fprintf(out, "%-20s | %6.2f | %6.2f |\n", "other", std::max(recentTotal - recentLoad, 0.0),
+            std::max(total - loopLoad, 0.0));
+    fprintf(out, "%-20s | %6.2f | %6.2f |\n", "total", recentTotal, total);
+}
+
+// measures the CPU monitor itself so it shows up in its own report
+LoopTimer cpuMonitorTimer("CPU Monitor", CpuConfig::SAMPLE_RATE);
+
+// Task that closes a CPU load window every second
+void cpu_monitor_task(void* param) {
+    while (true) {
+        cpu_monitor.update();
+
+        // Delay to save resources
+        cpuMonitorTimer.delay();
+    }
+}
+
+// Task that measures idle time, start it at TASK_PRIORITY_MIN
+void cpu_probe_task(void* param) {
+    cpu_monitor.runProbe();
+}
@@ -0,0 +1,182 @@
+#include "device_cache.h"
+#include "lemlib/api.hpp" // IWYU pragma: keep
+#include <cstdio>
+#include <cstdlib>
+#include "devices.h"
+
+namespace DeviceCacheConfig {
+    const int REFRESH_TIME = 250;
+    const int CYCLE_TIME = 10; // motors take a new command every 10 ms
+}
+
+int DeviceCache::indexOf(std::int8_t port) {
+    int index = abs(port) - 1;
+    return index >= 0 && index < DeviceCacheConfig::PORTS ? index : -1;
+}
+
+bool DeviceCache::motorAgrees(pros::AbstractMotor& motor, int index, const PortState& state) {
+    std::int32_t voltage = motor.get_voltage(index);
+    if (voltage == PROS_ERR) {
+        return false;
+    }
+    switch (state.command) {
+        case Command::MOVE:
+        case Command::VOLTAGE:
+            // a motor told to move that reads no voltage, or the other way, was written by something else
+            return state.value == 0 ? voltage == 0 : (voltage > 0) == (state.value > 0) && voltage != 0;
+        case Command::BRAKE:
+            // only a coasting motor is sure to read no voltage while braked
+            return state.brakeMode != pros::E_MOTOR_BRAKE_COAST || voltage == 0;
+        default:
+            return true;
+    }
+}
+
+void DeviceCache::command(pros::AbstractMotor& motor, Command command, std::int32_t value) {
+    // the lock is held across the write so two tasks commanding the same motor can't leave the cache out of order
+    std::lock_guard<pros::Mutex> lock(mutex);
+    std::uint32_t now = pros::millis();
+    int size = motor.size();
+
+    // only skip the write if every motor it goes to is owned and already has it
+    bool unchanged = true;
+    bool overwrites = false;
+    for (int i = 0; i < size; i++) {
+        int index = indexOf(motor.get_port(i));
+        if (index < 0) continue;
+        const PortState& state = ports[index];
+        bool same = state.command == command && state.value == value;
+        if (!state.owned || !same || now - state.commandTime >= static_cast<std::uint32_t>(DeviceCacheConfig::REFRESH_TIME)) {
+            unchanged = false;
+        }
+        // give the motor a cycle to act on the command before checking it did
+        else if (now - state.commandTime >= static_cast<std::uint32_t>(DeviceCacheConfig::CYCLE_TIME) &&
+                 !motorAgrees(motor, i, state)) {
+            unchanged = false;
+            resynced++;
+        }
+        if (!same && state.command != Command::UNKNOWN &&
+            now - state.commandTime < static_cast<std::uint32_t>(DeviceCacheConfig::CYCLE_TIME)) {
+            overwrites = true;
+        }
+    }
+    if (unchanged) {
+        suppressed++;
+        return;
+    }
+    if (overwrites) {
+        overwritten++;
+    }
+
+    switch (command) {
+        case Command::MOVE:
+            motor.move(value);
+            break;
+        case Command::VOLTAGE:
+            motor.move_voltage(value);
+            break;
+        case Command::VELOCITY:
+            motor.move_velocity(value);
+            break;
+        case Command::BRAKE:
+            motor.brake();
+            break;
+        default:
+            return;
+    }
+    sent++;
+
+    for (int i = 0; i < size; i++) {
+        int index = indexOf(motor.get_port(i));
+        if (index < 0) continue;
+        ports[index].command = command;
+        ports[index].value = value;
+        ports[index].commandTime = now;
+    }
+}
+
+void DeviceCache::own(pros::AbstractMotor& motor) {
+    std::lock_guard<pros::Mutex> lock(mutex);
+    for (int i = 0; i < motor.size(); i++) {
+        int index = indexOf(motor.get_port(i));
+        if (index >= 0) {
+            ports[index].owned = true;
+        }
+    }
+}
+
+void DeviceCache::move(pros::AbstractMotor& motor, std::int32_t power) {
+    command(motor, Command::MOVE, power);
+}
+
+void DeviceCache::moveVoltage(pros::AbstractMotor& motor, std::int32_t voltage) {
+    command(motor, Command::VOLTAGE, voltage);
+}
+
+void DeviceCache::moveVelocity(pros::AbstractMotor& motor, std::int32_t velocity) {
+    command(motor, Command::VELOCITY, velocity);
+}
+
+void DeviceCache::brake(pros::AbstractMotor& motor) {
+    command(motor, Command::BRAKE, 0);
+}
+
+void DeviceCache::setBrakeMode(pros::AbstractMotor& motor, pros::motor_brake_mode_e_t mode) {
+    std::lock_guard<pros::Mutex> lock(mutex);
+    std::uint32_t now = pros::millis();
+    // write motor by motor so a group only touches the motors another group didn't already set
+    for (int i = 0; i < motor.size(); i++) {
+        int index = indexOf(motor.get_port(i));
+        if (index < 0) continue;
+        PortState& state = ports[index];
+        if (state.brakeMode == mode &&
+            now - state.brakeModeTime < static_cast<std::uint32_t>(DeviceCacheConfig::REFRESH_TIME)) {
+            suppressed++;
+            continue;
+        }
+        motor.set_brake_mode(mode, i);
+        sent++;
+        state.brakeMode = mode;
+        state.brakeModeTime = now;
+    }
+}
+
+void DeviceCache::setPiston(pros::adi::Pneumatics& piston, bool extended) {
+    // the piston keeps its own state, so it is the cache
+    if (piston.is_extended() == extended) {
+        suppressed++;
+        return;
+    }
+    extended ? piston.extend() : piston.retract();
+    sent++;
+}
+
+void DeviceCache::invalidate() {
+    std::lock_guard<pros::Mutex> lock(mutex);
+    for (PortState& state : ports) {
+        state.command = Command::UNKNOWN;
+        state.brakeMode = -1;
+    }
+}
+
+int DeviceCache::getSent() {
+    return sent;
+}
+
+int DeviceCache::getSuppressed() {
+    return suppressed;
+}
+
+int DeviceCache::getOverwritten() {
+    return overwritten;
+}
+
+int DeviceCache::getResynced() {
+    return resynced;
+}
+
+void DeviceCache::printReport() {
+    int total = sent + suppressed;
+    printf("device writes: %d sent, %d suppressed (%.1f%%), %d overwritten within a cycle, %d resynced\n", getSent(),
+           getSuppressed(), total == 0 ? 0.0 : 100.0 * getSuppressed() / total, getOverwritten(), getResynced());
+}
@@ -0,0 +1,208 @@
+#include "device_health.h"
+#include "lemlib/api.hpp" // IWYU pragma: keep
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "devices.h"
+
+namespace HealthConfig {
+    const int UPDATE_RATE = 10; // every sensor loop runs at 10 ms or slower, so faults show up before they act
+    const int STALE_TIME = 100;
+    const double ERROR_WEIGHT = 0.05; // about the last 20 reads
+    const double MAX_ERROR_RATE = 0.2;
+}
+
+const int MAX_PORT = 21;
+
+bool DeviceHealth::read(const Entry& entry) {
+    switch (entry.type) {
+        case pros::DeviceType::motor:
+            return pros::c::motor_get_temperature(entry.port) != PROS_ERR_F;
+        case pros::DeviceType::optical:
+            return pros::c::optical_get_proximity(entry.port) != PROS_ERR;
+        case pros::DeviceType::rotation:
+            return pros::c::rotation_get_angle(entry.port) != PROS_ERR;
+        default:
+            // imu reads fail while it calibrates, being plugged in is enough
+            return true;
+    }
+}
+
+const char* DeviceHealth::faultName(DeviceFault fault) {
+    switch (fault) {
+        case DeviceFault::OK:
+            return "ok";
+        case DeviceFault::BAD_PORT:
+            return "bad port";
+        case DeviceFault::SHARED_PORT:
+            return "shared port";
+        case DeviceFault::WRONG_DEVICE:
+            return "wrong device";
+        case DeviceFault::DISCONNECTED:
+            return "unplugged";
+        case DeviceFault::STALE:
+            return "no data";
+        case DeviceFault::ERRORS:
+            return "read errors";
+        default:
+            return "?";
+    }
+}
+
+void DeviceHealth::add(const char* name, std::uint8_t port, pros::DeviceType type) {
+    std::lock_guard<pros::Mutex> lock(mutex);
+    if (count >= HealthConfig::MAX_DEVICES) {
+        return;
+    }
+    entries[count].name = name;
+    entries[count].port = port;
+    entries[count].type = type;
+    count++;
+}
+
+void DeviceHealth::add(const char* name, pros::AbstractMotor& motor) {
+    for (int i = 0; i < motor.size(); i++) {
+        add(name, abs(motor.get_port(i)), pros::DeviceType::motor);
+    }
+}
+
+bool DeviceHealth::validate() {
+    int faults = 0;
+    const Entry* first = nullptr;
+    {
+        std::lock_guard<pros::Mutex> lock(mutex);
+        int now = pros::millis();
+        for (int i = 0; i < count; i++) {
+            Entry& entry = entries[i];
+            entry.lastGood = now;
+            if (entry.port < 1 || entry.port > MAX_PORT) {
+                entry.configFault = DeviceFault::BAD_PORT;
+            }
+            else {
+                for (int j = 0; j < count; j++) {
+                    // motor groups register one entry per motor under the same name
+                    if (j != i && entries[j].port == entry.port && strcmp(entries[j].name, entry.name) != 0) {
+                        entry.configFault = DeviceFault::SHARED_PORT;
+                    }
+                }
+            }
+
+            if (entry.configFault != DeviceFault::OK) {
+                entry.fault = entry.configFault;
+            }
+            else {
+                // unplugged and wrong devices can still be fixed before the match, so update keeps checking them
+                pros::DeviceType plugged = pros::Device::get_plugged_type(entry.port);
+                entry.fault = plugged == pros::DeviceType::none ? DeviceFault::DISCONNECTED
+                              : plugged != entry.type          ? DeviceFault::WRONG_DEVICE
+                                                               : DeviceFault::OK;
+            }
+
+            if (entry.fault != DeviceFault::OK) {
+                faults++;
+                if (first == nullptr) {
+                    first = &entry;
+                }
+                printf("device %s on port %d: %s\n", entry.name, entry.port, faultName(entry.fault));
+            }
+        }
+    }
+
+    if (first != nullptr) {
+        pros::lcd::print(1, "WARN: %s %s on port %d%s", first->name, faultName(first->fault), first->port,
+                         faults > 1 ? ", more in terminal" : "");
+    }
+    return faults == 0;
+}
+
+void DeviceHealth::update() {
+    TRACE_ZONE("Device Health");
+    // entries are only added during initialize, so the ports can be read before taking the lock
+    int devices = count;
+    pros::DeviceType plugged[HealthConfig::MAX_DEVICES];
+    bool good[HealthConfig::MAX_DEVICES];
+    for (int i = 0; i < devices; i++) {
+        const Entry& entry = entries[i];
+        if (entry.configFault != DeviceFault::OK) {
+            continue;
+        }
+        plugged[i] = pros::Device::get_plugged_type(entry.port);
+        good[i] = plugged[i] == entry.type && read(entry);
+    }
+
+    // warnings are printed after unlocking
+    const char* faultedName = nullptr;
+    DeviceFault newFault = DeviceFault::OK;
+    int faultedPort = 0;
+    {
+        std::lock_guard<pros::Mutex> lock(mutex);
+        int now = pros::millis();
+        for (int i = 0; i < devices; i++) {
+            Entry& entry = entries[i];
+            if (entry.configFault != DeviceFault::OK) {
+                continue;
+            }
+            entry.errorRate = lemlib::ema(good[i] ? 0 : 1, entry.errorRate, HealthConfig::ERROR_WEIGHT);
+            if (good[i]) {
+                entry.lastGood = now;
+            }
+
+            DeviceFault fault = plugged[i] == pros::DeviceType::none     ? DeviceFault::DISCONNECTED
+                                : plugged[i] != entry.type                ? DeviceFault::WRONG_DEVICE
+                                : now - entry.lastGood > HealthConfig::STALE_TIME ? DeviceFault::STALE
+                                : entry.errorRate > HealthConfig::MAX_ERROR_RATE  ? DeviceFault::ERRORS
+                                                                                  : DeviceFault::OK;
+            if (fault != DeviceFault::OK && fault != entry.fault) {
+                faultedName = entry.name;
+                faultedPort = entry.port;
+                newFault = fault;
+            }
+            entry.fault = fault;
+        }
+    }
+
+    if (faultedName != nullptr) {
+        pros::lcd::print(1, "WARN: %s %s on port %d", faultedName, faultName(newFault), faultedPort);
+    }
+}
+
+bool DeviceHealth::isHealthy(std::uint8_t port) {
+    return getFault(port) == DeviceFault::OK;
+}
+
+DeviceFault DeviceHealth::getFault(std::uint8_t port) {
+    std::lock_guard<pros::Mutex> lock(mutex);
+    DeviceFault fault = DeviceFault::BAD_PORT; // nothing registered on the port
+    for (int i = 0; i < count; i++) {
+        if (entries[i].port != port) continue;
+        if (entries[i].fault != DeviceFault::OK) {
+            return entries[i].fault;
+        }
+        fault = DeviceFault::OK;
+    }
+    return fault;
+}
+
+void DeviceHealth::printReport() {
+    std::lock_guard<pros::Mutex> lock(mutex);
+    int now = pros::millis();
+    printf("%-16s | %4s | %-12s | %6s | %s\n", "device", "port", "fault", "errors", "last good ms ago");
+    for (int i = 0; i < count; i++) {
+        const Entry& entry = entries[i];
+        printf("%-16s | %4d | %-12s | %5.1f%% | %d\n", entry.name, entry.port, faultName(entry.fault),
+               entry.errorRate * 100, now - entry.lastGood);
+    }
+}
+
+// measures how late each health check wakes and how long it runs
+LoopTimer deviceHealthTimer("Device Health", HealthConfig::UPDATE_RATE);
+
+// Task that checks every device every cycle
+void device_health_task(void* param) {
+    while (true) {
+        device_health.update();
+
+        // Delay to save resources
+        deviceHealthTimer.delay();
+    }
+}
@@ -0,0 +1,203 @@
+#include "device_timing.h"
+#include "lemlib/api.hpp" // IWYU pragma: keep
+#include <cstdio>
+#include <cstdlib>
+#include "devices.h"
+
+namespace TimingConfig {
+    const int LEARN_TIME = 1000; // about 100 readings from every source
+    const int MIN_UPDATES = 50;
+    const double MIN_AGREEMENT = 0.6; // a poll delayed by another task lands on the next tick
+    const int WAKE_OFFSET = 0; // the tick a reading is first seen on already has it
+    const int CHECK_RATE = 1000;
+    const int MAX_AGE = 3000; // aligned loops should see readings under a tick old, this is a few ticks late
+    const double AGE_WEIGHT = 0.05;
+    const int RELEARN_TIME = 60000;
+}
+
+const char* SOURCE_NAMES[] = {"Drive", "Intake", "Ring Sensor"};
+
+// something from the source that changes with every new reading
+std::uint64_t readMarker(DataSource source) {
+    std::uint32_t timestamp = 0;
+    switch (source) {
+        case DataSource::DRIVE:
+            left_motors.get_raw_position(&timestamp, 0);
+            return timestamp;
+        case DataSource::INTAKE:
+            intake.get_raw_position(&timestamp);
+            return timestamp;
+        case DataSource::RING_SENSOR: {
+            // the optical sensor has no timestamp, but sensor noise changes the raw channels every integration
+            pros::c::optical_raw_s_t raw = ringSens.get_raw();
+            return (static_cast<std::uint64_t>(raw.red) << 48) ^ (static_cast<std::uint64_t>(raw.green) << 32) ^
+                   (static_cast<std::uint64_t>(raw.blue) << 16) ^ raw.clear;
+        }
+        default:
+            return 0;
+    }
+}
+
+DeviceTiming::DeviceTiming() {
+    for (int& phase : phases) {
+        phase = -1;
+    }
+}
+
+void DeviceTiming::learn() {
+    constexpr int count = static_cast<int>(DataSource::COUNT);
+    constexpr int period = TimingConfig::DEVICE_PERIOD;
+    int hits[count][period] = {};
+    int updates[count] = {};
+    std::uint64_t markers[count];
+    for (int i = 0; i < count; i++) {
+        markers[i] = readMarker(static_cast<DataSource>(i));
+    }
+
+    // poll every tick and note which tick each new reading first shows up on
+    std::uint32_t start = pros::millis();
+    std::uint32_t wake = start;
+    while (wake - start < static_cast<std::uint32_t>(TimingConfig::LEARN_TIME)) {
+        pros::c::task_delay_until(&wake, 1);
+        std::uint32_t tick = pros::millis();
+        for (int i = 0; i < count; i++) {
+            std::uint64_t marker = readMarker(static_cast<DataSource>(i));
+            if (marker != markers[i]) {
+                markers[i] = marker;
+                hits[i][tick % period]++;
+                updates[i]++;
+            }
+        }
+    }
+
+    int newPhases[count];
+    for (int i = 0; i < count; i++) {
+        int best = 0;
+        for (int tick = 1; tick < period; tick++) {
+            if (hits[i][tick] > hits[i][best]) {
+                best = tick;
+            }
+        }
+        bool trusted = updates[i] >= TimingConfig::MIN_UPDATES &&
+                       hits[i][best] >= TimingConfig::MIN_AGREEMENT * updates[i];
+        newPhases[i] = trusted ? best : -1;
+    }
+
+    std::lock_guard<pros::Mutex> lock(mutex);
+    for (int i = 0; i < count; i++) {
+        phases[i] = newPhases[i];
+        ages[i] = 0;
+    }
+    learned = true;
+    learnTime = pros::millis();
+}
+
+int DeviceTiming::getPhase(DataSource source) {
+    std::lock_guard<pros::Mutex> lock(mutex);
+    return phases[static_cast<int>(source)];
+}
+
+std::uint32_t DeviceTiming::getAge(DataSource source, bool aligned) {
+    if (source == DataSource::DRIVE || source == DataSource::INTAKE) {
+        // motors stamp each reading with the ms it was taken on, call it the middle of that ms
+        std::uint32_t timestamp = static_cast<std::uint32_t>(readMarker(source));
+        std::uint64_t now = pros::micros();
+        std::uint64_t taken = static_cast<std::uint64_t>(timestamp) * 1000 + 500;
+        if (timestamp == 0 || taken > now) {
+            return 0;
+        }
+        std::uint32_t age = static_cast<std::uint32_t>(now - taken);
+        if (!aligned) {
+            return age;
+        }
+        std::lock_guard<pros::Mutex> lock(mutex);
+        double& average = ages[static_cast<int>(source)];
+        average = average == 0 ? age : lemlib::ema(age, average, TimingConfig::AGE_WEIGHT);
+        return age;
+    }
+
+    // the optical sensor has no timestamp, estimate from its phase
+    int phase = getPhase(source);
+    if (phase < 0) {
+        return 0;
+    }
+    const std::uint64_t period = TimingConfig::DEVICE_PERIOD * 1000;
+    // the reading arrived some time in the ms before the tick it was first seen on, call it half way
+    std::uint64_t arrival = (phase * 1000 + period - 500) % period;
+    return static_cast<std::uint32_t>((pros::micros() % period + period - arrival) % period);
+}
+
+std::uint32_t DeviceTiming::nextWake(DataSource source, std::uint32_t lastWake, int period) {
+    const int devicePeriod = TimingConfig::DEVICE_PERIOD;
+    std::uint32_t target = lastWake + period;
+    int phase = getPhase(source);
+    std::uint32_t now = pros::millis();
+
+    if (phase < 0) {
+        // not learned, run at the plain period but never ask to wake in the past
+        return static_cast<std::int32_t>(target - now) > 0 ? target : now + 1;
+    }
+
+    // move to the aligned tick nearest the target, at most half a device period either way
+    int aligned = (phase + TimingConfig::WAKE_OFFSET) % devicePeriod;
+    int shift = (aligned - static_cast<int>(target % devicePeriod) + devicePeriod) % devicePeriod;
+    if (shift > devicePeriod / 2) {
+        shift -= devicePeriod;
+    }
+    target += shift;
+
+    // fell behind, take the next aligned tick rather than waking late
+    while (static_cast<std::int32_t>(target - now) <= 0) {
+        target += devicePeriod;
+    }
+    return target;
+}
+
+bool DeviceTiming::needsRelearn() {
+    std::lock_guard<pros::Mutex> lock(mutex);
+    if (!learned) {
+        return false;
+    }
+    if (pros::millis() - learnTime >= static_cast<std::uint32_t>(TimingConfig::RELEARN_TIME)) {
+        return true;
+    }
+    // only aligned motor sources are expected to be fresh
+    for (DataSource source : {DataSource::DRIVE, DataSource::INTAKE}) {
+        int i = static_cast<int>(source);
+        if (phases[i] >= 0 && ages[i] > TimingConfig::MAX_AGE) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void DeviceTiming::printReport() {
+    std::lock_guard<pros::Mutex> lock(mutex);
+    printf("device phases (ms within %d):", TimingConfig::DEVICE_PERIOD);
+    for (int i = 0; i < static_cast<int>(DataSource::COUNT); i++) {
+        if (!learned) {
+            printf(" %s learning", SOURCE_NAMES[i]);
+        } else if (phases[i] < 0) {
+            printf(" %s unknown", SOURCE_NAMES[i]);
+        } else {
+            printf(" %s %d", SOURCE_NAMES[i], phases[i]);
+        }
+        if (ages[i] > 0) {
+            printf(" (avg age %.0f us)", ages[i]);
+        }
+    }
+    printf("\n");
+}
+
+// Task that learns the device phases at startup and again when they drift
+void device_timing_task(void* param) {
+    device_timing.learn();
+    while (true) {
+        if (device_timing.needsRelearn()) {
+            device_timing.learn();
+        }
+
+        // Delay to save resources
+        pros::delay(TimingConfig::CHECK_RATE);
+    }
+}
@@ -85,7 +85,7 @@ ExpoDriveCurve throttle_curve(3,    // joystick deadband out of 127
 );
 
 // create the chassis
-Chassis chassis(drivetrain,         // drivetrain settings
+TriggerChassis chassis(drivetrain,         // drivetrain settings
                         lateral_controller, // lateral PID settings
                         angular_controller, // angular PID settings
                         sensors,            // odometry sensors
@@ -94,4 +94,54 @@ Chassis chassis(drivetrain,         // drivetrain settings
 
 // create the color sorter
 ColorSort color_sort;
-AutoClamp auto_clamp;
\ No newline at end of file
+AutoClamp auto_clamp;
+
+// create the runtime for autonomous coroutines
+AutonRuntime auton_runtime;
+
+// create the scheduler for timed actuator commands
+ActuatorScheduler actuator_scheduler;
+
+// create the field zones checked against odometry
+Geofence geofence;
+
+// create the filtered battery reading for compensated moves
+BatteryMonitor battery_monitor;
+
+// create the thermal model of every motor
+ThermalMonitor thermal_monitor;
+
+// create the current budget shared between the motors
+PowerManager power_manager;
+
+// create the intake jam handling
+IntakeController intake_controller;
+
+// create the ring counter for the intake
+RingTracker ring_tracker;
+
+// create the lookup table ring color classifier
+RingClassifier ring_classifier;
+
+// create the stack and heap monitor
+ResourceMonitor resource_monitor;
+
+// create the allocation tracker, constinit since objects allocate while globals are still being constructed
+constinit AllocTracker alloc_tracker;
+
+// create the per loop CPU load monitor
+CpuMonitor cpu_monitor;
+
+// create the cache that drops device writes that wouldn't change anything
+DeviceCache device_cache;
+
+// create the service that learns when devices deliver new readings
+DeviceTiming device_timing;
+
+// create the registry that checks every smart port device
+DeviceHealth device_health;
+
+#if TRACE_ENABLED
+// create the timeline tracer, constinit so zones in global constructors can record
+constinit Tracer tracer;
+#endif
@@ -0,0 +1,194 @@
+#include "geofence.h"
+#include "lemlib/api.hpp" // IWYU pragma: keep
+#include <cstdlib>
+#include "devices.h"
+
+namespace GeofenceConfig {
+    const float FIELD_SIZE = 144; // 12 foot field
+    const int UPDATE_RATE = 10; // same rate lemlib updates odometry
+}
+
+int Geofence::addCircle(float x, float y, float radius, std::function<void()> onEnter,
+                        std::function<void()> onExit, bool once) {
+    Zone zone;
+    zone.shape = ZoneShape::CIRCLE;
+    zone.x[0] = x;
+    zone.y[0] = y;
+    zone.vertexCount = 1;
+    zone.radius = radius;
+    zone.once = once;
+    zone.onEnter = std::move(onEnter);
+    zone.onExit = std::move(onExit);
+    return addZone(std::move(zone), x - radius, y - radius, x + radius, y + radius);
+}
+
+int Geofence::addPolygon(std::initializer_list<lemlib::Pose> vertices, std::function<void()> onEnter,
+                         std::function<void()> onExit, bool once) {
+    if (vertices.size() < 3 || vertices.size() > GeofenceConfig::MAX_VERTICES) {
+        pros::lcd::print(1, "WARN: Geofence polygon needs 3 to %d corners", GeofenceConfig::MAX_VERTICES);
+        return -1;
+    }
+
+    Zone zone;
+    zone.shape = ZoneShape::POLYGON;
+    zone.vertexCount = 0;
+    zone.radius = 0;
+    zone.once = once;
+    zone.onEnter = std::move(onEnter);
+    zone.onExit = std::move(onExit);
+
+    // find the bounding box while copying the corners
+    float minX = vertices.begin()->x, maxX = minX;
+    float minY = vertices.begin()->y, maxY = minY;
+    for (const lemlib::Pose& vertex : vertices) {
+        zone.x[zone.vertexCount] = vertex.x;
+        zone.y[zone.vertexCount] = vertex.y;
+        zone.vertexCount++;
+        minX = std::min(minX, vertex.x);
+        maxX = std::max(maxX, vertex.x);
+        minY = std::min(minY, vertex.y);
+        maxY = std::max(maxY, vertex.y);
+    }
+    return addZone(std::move(zone), minX, minY, maxX, maxY);
+}
+
+int Geofence::addZone(Zone zone, float minX, float minY, float maxX, float maxY) {
+    std::lock_guard<pros::Mutex> lock(mutex);
+    for (int i = 0; i < GeofenceConfig::MAX_ZONES; i++) {
+        if (zones[i].state != ZoneState::EMPTY) continue;
+
+        zones[i] = std::move(zone);
+        zones[i].state = ZoneState::ACTIVE;
+
+        // mark the zone in every cell its bounding box touches
+        for (int row = cellIndex(minY); row <= cellIndex(maxY); row++) {
+            for (int col = cellIndex(minX); col <= cellIndex(maxX); col++) {
+                grid[row][col] |= 1u << i;
+            }
+        }
+        return i;
+    }
+
+    pros::lcd::print(1, "WARN: Geofence zone dropped b/c all slots are full");
+    return -1;
+}
+
+void Geofence::remove(int id) {
+    if (id < 0 || id >= GeofenceConfig::MAX_ZONES) return;
+
+    std::lock_guard<pros::Mutex> lock(mutex);
+    if (zones[id].state == ZoneState::ACTIVE) {
+        zones[id].state = ZoneState::REMOVED;
+    }
+}
+
+void Geofence::clear() {
+    std::lock_guard<pros::Mutex> lock(mutex);
+    for (Zone& zone : zones) {
+        if (zone.state == ZoneState::ACTIVE) {
+            zone.state = ZoneState::REMOVED;
+        }
+    }
+}
+
+bool Geofence::isInside(int id) {
+    if (id < 0 || id >= GeofenceConfig::MAX_ZONES) return false;
+
+    std::lock_guard<pros::Mutex> lock(mutex);
+    return insideMask & (1u << id);
+}
+
+int Geofence::cellIndex(float coord) const {
+    // poses off the field use the nearest edge cell
+    int index = (coord + GeofenceConfig::FIELD_SIZE / 2) * GeofenceConfig::GRID_CELLS / GeofenceConfig::FIELD_SIZE;
+    return std::clamp(index, 0, GeofenceConfig::GRID_CELLS - 1);
+}
+
+bool Geofence::contains(const Zone& zone, float x, float y) const {
+    if (zone.shape == ZoneShape::CIRCLE) {
+        float dx = x - zone.x[0];
+        float dy = y - zone.y[0];
+        return dx * dx + dy * dy <= zone.radius * zone.radius;
+    }
+
+    // count how many edges a ray to the right of the point crosses, odd means inside
+    bool inside = false;
+    for (int i = 0, j = zone.vertexCount - 1; i < zone.vertexCount; j = i++) {
+        bool crosses = (zone.y[i] > y) != (zone.y[j] > y);
+        if (crosses && x < (zone.x[j] - zone.x[i]) * (y - zone.y[i]) / (zone.y[j] - zone.y[i]) + zone.x[i]) {
+            inside = !inside;
+        }
+    }
+    return inside;
+}
+
+void Geofence::update(lemlib::Pose pose) {
+    struct Event {
+        Zone* zone;
+        bool entered;
+    };
+    Event events[GeofenceConfig::MAX_ZONES];
+    int eventCount = 0;
+
+    {
+        std::lock_guard<pros::Mutex> lock(mutex);
+
+        // zones are only cleared here, so a zone is never cleared while its action runs
+        for (int i = 0; i < GeofenceConfig::MAX_ZONES; i++) {
+            if (zones[i].state != ZoneState::REMOVED) continue;
+
+            for (auto& row : grid) {
+                for (std::uint32_t& cell : row) {
+                    cell &= ~(1u << i);
+                }
+            }
+            insideMask &= ~(1u << i);
+            zones[i].onEnter = nullptr;
+            zones[i].onExit = nullptr;
+            zones[i].state = ZoneState::EMPTY;
+        }
+
+        // only zones in this cell can be entered, and only zones we are in can be left
+        std::uint32_t candidates = grid[cellIndex(pose.y)][cellIndex(pose.x)] | insideMask;
+        while (candidates != 0) {
+            int i = __builtin_ctz(candidates);
+            candidates &= candidates - 1;
+
+            std::uint32_t bit = 1u << i;
+            bool inside = contains(zones[i], pose.x, pose.y);
+            bool wasInside = insideMask & bit;
+
+            if (inside && !wasInside) {
+                insideMask |= bit;
+                events[eventCount++] = {&zones[i], true};
+                if (zones[i].once) {
+                    zones[i].state = ZoneState::REMOVED;
+                }
+            } else if (!inside && wasInside) {
+                insideMask &= ~bit;
+                events[eventCount++] = {&zones[i], false};
+            }
+        }
+    }
+
+    // fire outside of the lock so actions can add and remove zones
+    for (int i = 0; i < eventCount; i++) {
+        std::function<void()>& action = events[i].entered ? events[i].zone->onEnter : events[i].zone->onExit;
+        if (action) {
+            action();
+        }
+    }
+}
+
+// measures how late each zone check wakes and how long it runs
+LoopTimer geofenceTimer("Geofence", GeofenceConfig::UPDATE_RATE);
+
+// Task that checks the robot pose against the geofence zones every odometry update
+void geofence_task(void *param) {
+    while (true) {
+        geofence.update(chassis.getPose());
+
+        // Delay to save resources
+        geofenceTimer.delay();
+    }
+}
@@ -0,0 +1,181 @@
+#include "intake_controller.h"
+#include "lemlib/api.hpp" // IWYU pragma: keep
+#include <cstdlib>
+#include "devices.h"
+
+namespace IntakeConfig {
+    const double STALL_VELOCITY = 60; // a tenth of full speed on the blue cartridge
+    const double STALL_CURRENT = 0.9; // a stalled motor draws right up to its limit
+    const double STALL_TORQUE = 0.25; // about 70% of the blue cartridge's 0.35 Nm stall torque
+    const int STALL_TIME = 100;
+    const int SPINUP_TIME = 250;
+    const int UNJAM_POWER = 70;
+    const int REVERSE_TIME = 150;
+    const int MAX_RETRIES = 3;
+    const int RETRY_WINDOW = 1000;
+    const int UPDATE_RATE = 10;
+}
+
+void IntakeController::send(double sendPower) {
+    if (compensated) {
+        battery_monitor.move(intake, sendPower);
+    } else {
+        device_cache.move(intake, sendPower);
+    }
+}
+
+void IntakeController::move(double newPower, bool compensate) {
+    if (newPower == 0) {
+        brake();
+        return;
+    }
+
+    power_manager.command(PowerSubsystem::INTAKE);
+    std::lock_guard<pros::Mutex> lock(mutex);
+    // resending the same power every loop must not restart the spin up, or a jam that wouldn't clear
+    if (state == State::GAVE_UP && newPower == power) {
+        return;
+    }
+    if (state == State::RUNNING && newPower == power && compensate == compensated) {
+        // still send it, the device cache drops it unless the motor stopped doing it
+        send(power);
+        return;
+    }
+    power = newPower;
+    compensated = compensate;
+    retries = 0;
+    stallStart = -1;
+    // a jam being cleared goes back to the new power once it finishes reversing
+    if (state == State::REVERSING) {
+        return;
+    }
+    state = State::RUNNING;
+    stateStart = pros::millis();
+    spinupEnd = stateStart + IntakeConfig::SPINUP_TIME;
+    send(power);
+}
+
+void IntakeController::brake() {
+    std::lock_guard<pros::Mutex> lock(mutex);
+    if (state == State::REVERSING) {
+        lostTime += pros::millis() - jamStart;
+    }
+    state = State::IDLE;
+    power = 0;
+    device_cache.brake(intake);
+}
+
+void IntakeController::update() {
+    TRACE_ZONE("Intake Control");
+    // read before taking the lock so a move isn't held up by the reads
+    double velocity = intake.get_actual_velocity();
+    std::int32_t current = intake.get_current_draw();
+    double torque = intake.get_torque();
+    // the limit power_manager set, so a stall is still seen when the intake is held to its minimum
+    int allocation = power_manager.getAllocation(PowerSubsystem::INTAKE);
+    if (allocation == 0) {
+        allocation = PowerConfig::MAX_LIMIT; // nothing allocated yet, the motor runs at its own limit
+    }
+
+    bool gaveUp = false;
+    {
+        std::lock_guard<pros::Mutex> lock(mutex);
+        int currentTime = pros::millis();
+
+        if (state == State::REVERSING) {
+            if (currentTime - stateStart < IntakeConfig::REVERSE_TIME) {
+                return;
+            }
+            // jam cleared, back to the requested power
+            lostTime += currentTime - jamStart;
+            lastUnjam = currentTime;
+            state = State::RUNNING;
+            stateStart = currentTime;
+            spinupEnd = currentTime + IntakeConfig::SPINUP_TIME;
+            stallStart = -1;
+            send(power);
+            return;
+        }
+        if (state != State::RUNNING) {
+            return;
+        }
+
+        // running long enough without a jam means the last one really cleared
+        if (retries > 0 && currentTime - lastUnjam > IntakeConfig::RETRY_WINDOW) {
+            retries = 0;
+        }
+
+        // a motor that can't be read never looks stalled
+        bool readable = velocity != PROS_ERR_F && current != PROS_ERR && torque != PROS_ERR_F;
+        bool stalled = readable && currentTime >= spinupEnd && fabs(velocity) < IntakeConfig::STALL_VELOCITY &&
+                       (current > IntakeConfig::STALL_CURRENT * allocation || torque > IntakeConfig::STALL_TORQUE);
+        if (!stalled) {
+            stallStart = -1;
+            return;
+        }
+        if (stallStart < 0) {
+            stallStart = currentTime;
+        }
+        if (currentTime - stallStart < IntakeConfig::STALL_TIME) {
+            return;
+        }
+
+        jamCount++;
+        jamStart = stallStart;
+        stallStart = -1;
+        if (retries >= IntakeConfig::MAX_RETRIES) {
+            // the same jam keeps coming back, stop before the motor overheats
+            lostTime += currentTime - jamStart;
+            state = State::GAVE_UP;
+            device_cache.brake(intake);
+            gaveUp = true;
+        } else {
+            // reverse against whichever way the intake was running
+            retries++;
+            state = State::REVERSING;
+            stateStart = currentTime;
+            send(power > 0 ? -IntakeConfig::UNJAM_POWER : IntakeConfig::UNJAM_POWER);
+        }
+    }
+
+    if (gaveUp) {
+        pros::lcd::print(1, "WARN: Intake jam won't clear, intake stopped");
+    }
+}
+
+bool IntakeController::isStuck() {
+    std::lock_guard<pros::Mutex> lock(mutex);
+    return state == State::GAVE_UP;
+}
+
+int IntakeController::getJamCount() {
+    std::lock_guard<pros::Mutex> lock(mutex);
+    return jamCount;
+}
+
+int IntakeController::getLostTime() {
+    std::lock_guard<pros::Mutex> lock(mutex);
+    return lostTime;
+}
+
+void IntakeController::resetStats() {
+    std::lock_guard<pros::Mutex> lock(mutex);
+    jamCount = 0;
+    lostTime = 0;
+}
+
+// measures how late each jam check wakes and how long it runs
+LoopTimer intakeControlTimer("Intake Control", IntakeConfig::UPDATE_RATE);
+
+// Task that watches the intake for jams and clears them
+void intake_control_task(void *param) {
+    std::uint32_t wake = pros::millis();
+    while (true) {
+        intakeControlTimer.recordAge(device_timing.getAge(DataSource::INTAKE));
+        intake_controller.update();
+
+        // Wake just after the intake has a new reading
+        wake = device_timing.nextWake(DataSource::INTAKE, wake, IntakeConfig::UPDATE_RATE);
+        intakeControlTimer.delayUntil(wake);
+    }
+}
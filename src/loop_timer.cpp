@@ -0,0 +1,174 @@
+#include "loop_timer.h"
+#include "lemlib/api.hpp" // IWYU pragma: keep
+#include <atomic>
+#include <cstdlib>
+#include "devices.h"
+
+namespace LoopTimerConfig {
+    const char* DUMP_FILE = "/usd/loop_latency.txt";
+}
+
+const int SUB_BUCKETS = 1 << LoopTimerConfig::SUB_BUCKET_BITS;
+
+// constant initialized so timers constructed as globals in other files can register in any order
+LoopTimer* timers[LoopTimerConfig::MAX_TIMERS] = {};
+std::atomic<int> timerCount = 0;
+
+int LatencyHistogram::bucketOf(std::uint32_t micros) {
+    if (micros < SUB_BUCKETS) {
+        return micros;
+    }
+    int topBit = 31 - __builtin_clz(micros);
+    if (topBit >= LoopTimerConfig::MAX_BITS) {
+        return LoopTimerConfig::BUCKETS - 1;
+    }
+    int shift = topBit - LoopTimerConfig::SUB_BUCKET_BITS;
+    return (shift + 1) * SUB_BUCKETS + static_cast<int>((micros >> shift) - SUB_BUCKETS);
+}
+
+std::uint32_t LatencyHistogram::bucketTop(int bucket) {
+    int octave = bucket / SUB_BUCKETS;
+    int sub = bucket % SUB_BUCKETS;
+    if (octave == 0) {
+        return sub;
+    }
+    // one less than the bottom of the next bucket
+    return (static_cast<std::uint32_t>(SUB_BUCKETS + sub + 1) << (octave - 1)) - 1;
+}
+
+void LatencyHistogram::record(std::uint32_t micros) {
+    counts[bucketOf(micros)]++;
+    total++;
+    if (micros > max) {
+        max = micros;
+    }
+}
+
+std::uint32_t LatencyHistogram::percentile(double fraction) const {
+    if (total == 0) {
+        return 0;
+    }
+    std::uint32_t rank = static_cast<std::uint32_t>(fraction * (total - 1)) + 1;
+    std::uint32_t seen = 0;
+    for (int bucket = 0; bucket < LoopTimerConfig::BUCKETS; bucket++) {
+        seen += counts[bucket];
+        if (seen >= rank) {
+            // the bucket edge can overshoot the real longest, and the last bucket holds everything past it
+            return bucket == LoopTimerConfig::BUCKETS - 1 ? max : std::min(bucketTop(bucket), max);
+        }
+    }
+    return max;
+}
+
+std::uint32_t LatencyHistogram::getMax() const {
+    return max;
+}
+
+std::uint32_t LatencyHistogram::getCount() const {
+    return total;
+}
+
+void LatencyHistogram::reset() {
+    for (std::uint32_t& count : counts) {
+        count = 0;
+    }
+    total = 0;
+    max = 0;
+}
+
+LoopTimer::LoopTimer(const char* name, int period) : name(name), period(period) {
+    int index = timerCount.fetch_add(1);
+    if (index < LoopTimerConfig::MAX_TIMERS) {
+        timers[index] = this;
+    }
+}
+
+void LoopTimer::recordExecution(std::uint64_t sleepTime) {
+    if (wakeTime != 0) {
+        execution.record(sleepTime - wakeTime);
+        // only this task writes, the atomic just keeps readers from seeing a torn value
+        runTime.store(runTime.load(std::memory_order_relaxed) + (sleepTime - wakeTime), std::memory_order_relaxed);
+    }
+}
+
+void LoopTimer::delay() {
+    std::uint64_t sleepTime = pros::micros();
+    recordExecution(sleepTime);
+
+    pros::delay(period);
+
+    wakeTime = pros::micros();
+    std::uint64_t expected = sleepTime + period * 1000;
+    lateness.record(wakeTime > expected ? wakeTime - expected : 0);
+}
+
+void LoopTimer::delayUntil(std::uint32_t wake) {
+    recordExecution(pros::micros());
+
+    std::uint32_t now = pros::millis();
+    if (static_cast<std::int32_t>(wake - now) > 0) {
+        pros::delay(wake - now);
+    }
+
+    wakeTime = pros::micros();
+    std::uint64_t expected = static_cast<std::uint64_t>(wake) * 1000;
+    lateness.record(wakeTime > expected ? wakeTime - expected : 0);
+}
+
+void LoopTimer::recordAge(std::uint32_t micros) {
+    age.record(micros);
+}
+
+const char* LoopTimer::getName() const {
+    return name;
+}
+
+std::uint32_t LoopTimer::getRunTime() const {
+    return runTime.load(std::memory_order_relaxed);
+}
+
+void LoopTimer::print(FILE* out) const {
+    fprintf(out, "%-20s | %7u | %6u %6u %6u | %6u %6u %6u | %6u %6u\n", name,
+            static_cast<unsigned>(execution.getCount()), static_cast<unsigned>(lateness.percentile(0.5)),
+            static_cast<unsigned>(lateness.percentile(0.99)), static_cast<unsigned>(lateness.getMax()),
+            static_cast<unsigned>(execution.percentile(0.5)), static_cast<unsigned>(execution.percentile(0.99)),
+            static_cast<unsigned>(execution.getMax()), static_cast<unsigned>(age.percentile(0.5)),
+            static_cast<unsigned>(age.percentile(0.99)));
+}
+
+void LoopTimer::reset() {
+    lateness.reset();
+    execution.reset();
+    age.reset();
+}
+
+int getLoopTimerCount() {
+    return std::min(timerCount.load(), LoopTimerConfig::MAX_TIMERS);
+}
+
+LoopTimer* getLoopTimer(int index) {
+    return timers[index];
+}
+
+void dumpLoopTimers(FILE* out) {
+    fprintf(out, "%-20s | %7s | %20s | %20s | %13s\n", "loop", "cycles", "late us p50 p99 max", "run us p50 p99 max",
+            "age us p50 p99");
+    int count = getLoopTimerCount();
+    for (int i = 0; i < count; i++) {
+        timers[i]->print(out);
+    }
+}
+
+bool dumpLoopTimersToSd() {
+    if (!pros::usd::is_installed()) {
+        return false;
+    }
+    FILE* file = fopen(LoopTimerConfig::DUMP_FILE, "a");
+    if (file == nullptr) {
+        return false;
+    }
+    fprintf(file, "--- %u ms ---\n", static_cast<unsigned>(pros::millis()));
+    dumpLoopTimers(file);
+    fclose(file);
+    return true;
+}
@@ -14,6 +14,7 @@
 #include "auton_selector.h"
 #include "testing.h"
 #include "old_systems.h"
+#include "pid_tuner.h"
 
 // Global variables needed for oc control
 int ocMove = NONE;
@@ -56,8 +57,8 @@ const double OC_MAX_TORQUE = 999;
                     ocPID.reset();
 
                     // stop oc motors in place
-                    oc_motor.set_brake_mode(E_MOTOR_BRAKE_COAST);
-                    oc_motor.brake();
+                    device_cache.setBrakeMode(oc_motor, E_MOTOR_BRAKE_COAST);
+                    device_cache.brake(oc_motor);
 
                     // stop running the PID code
                     ocMove = NONE;
@@ -75,7 +76,7 @@ const double OC_MAX_TORQUE = 999;
             }
 
             // move oc motors based on PID
-            oc_motor.move_velocity(nextMovement);
+            device_cache.moveVelocity(oc_motor, nextMovement);
         }
         // linear driving for high movement
         else if(ocMove == HIGH){
@@ -85,17 +86,17 @@ const double OC_MAX_TORQUE = 999;
             error = currentPos - OC_POSITION_HIGH;
 
             if(error > 0){
-                oc_motor.move(127);
+                device_cache.move(oc_motor, 127);
             }
             else{
-                oc_motor.set_brake_mode(E_MOTOR_BRAKE_HOLD);
-                oc_motor.brake();
+                device_cache.setBrakeMode(oc_motor, E_MOTOR_BRAKE_HOLD);
+                device_cache.brake(oc_motor);
                 ocMove = NONE;
             }
             
         }
         else if(ocMove == NONE){
-            oc_motor.brake();
+            device_cache.brake(oc_motor);
         }
         // in case there is drift
         /*else if(ocMove == IDLE_LOW){
@@ -120,18 +121,64 @@ void initialize()
 {
 
     lcd::initialize();   // initialize the LCD screen on the VEX brain
-    chassis.calibrate(); // Calibrates the chassis sensors to ensure accurate readings
+
+    // Register every smart port device and check the wiring before anything uses them
+    device_health.add("Left Drive", left_motors);
+    device_health.add("Right Drive", right_motors);
+    device_health.add("Intake", intake);
+    device_health.add("OC Motor", oc_motor);
+    device_health.add("OC Rotation", ocRot.get_port(), pros::DeviceType::rotation);
+    device_health.add("Ring Sensor", ringSens.get_port(), pros::DeviceType::optical);
+    device_health.add("Goal Sensor", goalSens.get_port(), pros::DeviceType::optical);
+    device_health.add("IMU", imu.get_port(), pros::DeviceType::imu);
+    device_health.validate(); // warns on the LCD and terminal about bad ports and missing devices
+    chassis.calibrateAsync(); // Calibrates the chassis sensors in the background, motions wait for it if they need to
+    loadControllerSettings(); // Applies tuned PID settings from the SD card if there are any
 
     clamp.retract(); // Set the clamp to the high position
     oc_piston.retract(); // Set the oc piston to the low position
 
     ringSens.set_led_pwm(100); // Set the LED brightness to 100%
     ringSens.set_integration_time(10); // Sets the integration time for the ring sensor to 10ms
+    goalSens.set_integration_time(10); // Sets the integration time for the goal sensor to 10ms for clamp prediction
+    ring_classifier.init(); // Loads the venue calibration or trained ring lookup table from the SD card if there is one
+    // Hold Y while the program starts to recalibrate the ring colors under this venue's lighting
+    if (controller.get_digital(E_CONTROLLER_DIGITAL_Y)) {
+        ring_classifier.calibrate();
+    }
 
-    oc_motor.set_brake_mode_all(E_MOTOR_BRAKE_COAST); // Set all motors to coast mode
+    device_cache.own(intake); // Only moved through the cache, so repeated intake commands can be dropped
+    device_cache.own(oc_motor); // Only moved through the cache, so repeated oc commands can be dropped
+    device_cache.setBrakeMode(oc_motor, E_MOTOR_BRAKE_COAST); // Set all motors to coast mode
 
+    // Create a task for checking every device each cycle, high priority so faults are caught before loops use them
+    Task health_task(device_health_task, nullptr, TASK_PRIORITY_MAX - 2, TASK_STACK_DEPTH_DEFAULT, "Device Health Task");
+    // Create a task for learning when each device delivers new readings, high priority so it polls every tick
+    Task timing_task(device_timing_task, nullptr, TASK_PRIORITY_MAX - 2, TASK_STACK_DEPTH_DEFAULT, "Device Timing Task");
     // Create a task for controlling the oc motor
     //Task oc_task(oc_control_task, nullptr, "oc Control Task");
+    // Create a task for firing actions partway through chassis motions
+    Task trigger_task(motion_trigger_task, nullptr, TASK_PRIORITY_DEFAULT + 1, TASK_STACK_DEPTH_DEFAULT, "Motion Trigger Task");
+    // Create a task for running timed actuator commands, high priority so commands run on time
+    Task scheduler_task(actuator_scheduler_task, nullptr, TASK_PRIORITY_MAX - 2, TASK_STACK_DEPTH_DEFAULT, "Actuator Scheduler Task");
+    // Create a task for firing actions when the robot enters field zones
+    Task geofence_zone_task(geofence_task, nullptr, "Geofence Task");
+    // Create a task for filtering the battery voltage for compensated moves
+    Task battery_monitor_task(battery_task, nullptr, "Battery Task");
+    // Create a task for predicting when motors will overheat and derating the drive before they do
+    Task thermal_model_task(thermal_task, nullptr, "Thermal Task");
+    // Create a task for splitting the current budget between the motors
+    Task power_budget_task(power_task, nullptr, "Power Task");
+    // Create a task for clearing intake jams
+    Task intake_jam_task(intake_control_task, nullptr, "Intake Control Task");
+    // Create a task for counting rings from the intake current and ring sensor
+    Task ring_count_task(ring_tracker_task, nullptr, "Ring Tracker Task");
+    // Create a task for watching task stacks and the heap
+    Task resource_task(resource_monitor_task, nullptr, "Resource Monitor Task");
+    // Create a task for measuring how much of the CPU each loop uses
+    Task cpu_task(cpu_monitor_task, nullptr, "CPU Monitor Task");
+    // Create a task that soaks up idle time to measure total load, below every other task
+    Task probe_task(cpu_probe_task, nullptr, TASK_PRIORITY_MIN, TASK_STACK_DEPTH_MIN, "CPU Probe Task");
     // Create a task for outputting motor temps
     if(!competition::is_connected()){
         Task temp_task(motor_temp_task, nullptr, "Motor Temp Task");
@@ -142,12 +189,21 @@ void initialize()
 
 void autonomous()
 {
-        all_motors.set_brake_mode_all(E_MOTOR_BRAKE_HOLD);
+        chassis.waitUntilCalibrated(); // returns right away unless auton started straight after power on
+        intake_controller.resetStats();
+        ring_tracker.reset();
         competitionSelector.runSelection();
+        auton_runtime.cancelAll(); // stop any mechanism branches the route left running
+        actuator_scheduler.cancelAll(); // drop any timed commands the route left waiting
+        geofence.clear(); // drop any field zones the route left behind
+        power_manager.setMode(PowerMode::BALANCED); // hand the budget back in case the route left a priority set
+        // report how much the route lost to intake jams
+        pros::lcd::print(2, "Intake jams: %d, lost %d ms", intake_controller.getJamCount(), intake_controller.getLostTime());
+        pros::lcd::print(3, "Rings: %d", ring_tracker.getRingCount());
         all_motors.brake();
-        oc_motor.brake();
+        device_cache.brake(oc_motor);
         delay(1000);
-        all_motors.set_brake_mode_all(E_MOTOR_BRAKE_COAST);
+        device_cache.setBrakeMode(all_motors, E_MOTOR_BRAKE_COAST);
 }
 
 /**
@@ -181,6 +237,9 @@ void competition_initialize()
     lcd::register_btn0_cb(on_left_button);
     lcd::register_btn1_cb(on_center_button);
     lcd::register_btn2_cb(on_right_button);
+
+    // stage the route that's already selected, the buttons restage it on every change
+    competitionSelector.prewarm();
 }
 
 const double SMOOTHING_DENOMINATOR = 100; // Used to normalize the exponential curve
@@ -217,6 +276,15 @@ void handleDriveTrain()
     leftY *= 6;
     rightY *= 6;
 
+    // soften acceleration once the drive motors are running out of thermal budget
+    static double prevLeftY = 0, prevRightY = 0;
+    leftY = prevLeftY = thermal_monitor.limitDriveAcceleration(leftY, prevLeftY);
+    rightY = prevRightY = thermal_monitor.limitDriveAcceleration(rightY, prevRightY);
+
+    // let the drive have its current before the draw shows it is moving
+    if (leftY != 0 || rightY != 0) {
+        power_manager.command(PowerSubsystem::DRIVE);
+    }
     left_motors.move_velocity(leftY);
     right_motors.move_velocity(rightY);
 }
@@ -226,17 +294,17 @@ void handleIntake(pros::controller_digital_e_t buttonUp, pros::controller_digita
     // intake
     if (controller.get_digital(buttonUp))
     {
-        intake.move(127);
+        intake_controller.move(127, false); // driver control isn't battery compensated
     }
     // outtake
     else if (controller.get_digital(buttonDown))
     {
-        intake.move(-127);
+        intake_controller.move(-127, false);
     }
     // no movement without button pressed
     else
     {
-        intake.brake();
+        intake_controller.brake();
     }
     
 }
@@ -255,23 +323,23 @@ void handleOCMotor(pros::controller_digital_e_t button)
     }*/
     if (controller.get_digital(button))
     {
-        oc_motor.move(-127);
+        device_cache.move(oc_motor, -127);
     }
     else{
         ocAngle = ocRot.get_angle()/100.0;
         if(ocAngle>330||ocAngle<20){
-            oc_motor.set_brake_mode(E_MOTOR_BRAKE_COAST);
+            device_cache.setBrakeMode(oc_motor, E_MOTOR_BRAKE_COAST);
             //if(oc_motor.get_temperature() < 45){
             //    oc_motor.move(-9);
             //}
             //else{
-                oc_motor.brake();
+                device_cache.brake(oc_motor);
             //}
         }
         else{
-            oc_motor.move(127);
+            device_cache.move(oc_motor, 127);
             delay(1000);
-            oc_motor.brake();
+            device_cache.brake(oc_motor);
         }
     }
 }
@@ -289,10 +357,13 @@ void handleOCMotor(pros::controller_digital_e_t button)
  * operator control task will be stopped. Re-enabling the robot will restart the
  * task, not resume it from where it left off.
  */
+// measures how late each driver control cycle wakes and how long it runs
+LoopTimer opcontrolTimer("Opcontrol", 20);
+
 void opcontrol()
 {
 
-    all_motors.set_brake_mode(pros::E_MOTOR_BRAKE_COAST);
+    device_cache.setBrakeMode(all_motors, pros::E_MOTOR_BRAKE_COAST);
 
     // loop forever
     while (true)
@@ -308,8 +379,19 @@ void opcontrol()
         left_doinker.handle();
         right_doinker.handle();
         redirect.handle();
+
+        // dump loop latency percentiles on demand while practicing
+        if (!inCompetition && controller.get_digital_new_press(pros::E_CONTROLLER_DIGITAL_UP)) {
+            dumpLoopTimers(stdout);
+            dumpLoopTimersToSd();
+            cpu_monitor.printReport();
+            device_cache.printReport();
+            device_timing.printReport();
+            device_health.printReport();
+            dumpTrace();
+        }
         
         // delay to save resources
-        pros::delay(20);
+        opcontrolTimer.delay();
     }
 }
\ No newline at end of file
@@ -2,7 +2,6 @@
 #include "pros/motors.h"
 #include <cstdlib>
 #include "devices.h"
-#include <numeric>
 
 // Define constants for conversions
 const double WHEEL_RADIUS = 1.375;               // Inches
@@ -49,14 +48,18 @@ void drivePID(double inches, int timeout, double kP, double kI, double kD, doubl
   // Reset motor encoder value to 0
   all_motors.tare_position_all();
 
+  LoopGuard guard("drivePID"); // reports any allocation inside the control loop
   while (inGoal < goalsNeeded) // CHECK IF IT SHOULD BE A < or <=
   {
     // Main PID loop; runs until target is reached
     // Read motor position (you can average left and right motor values for straight driving)
     
-    // finds average motor position
-    std::vector<double> positions = all_motors.get_position_all();
-    double currentPosition = std::accumulate(positions.begin(), positions.end(), 0.0) / positions.size();
+    // finds average motor position, one motor at a time since get_position_all allocates a vector every cycle
+    double positionSum = 0;
+    for (int i = 0; i < all_motors.size(); i++) {
+      positionSum += all_motors.get_position(i);
+    }
+    double currentPosition = positionSum / all_motors.size();
     
     // Calculate the current error
     currentDelta = target - currentPosition;
@@ -120,6 +123,7 @@ void drivePID(double inches, int timeout, double kP, double kI, double kD, doubl
     */
 
     // Wait for the polling rate before next iteration
+    guard.tick();
     delay(pollingRate);
   }
   // Stop the motors once goal is met
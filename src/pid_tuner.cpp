@@ -0,0 +1,308 @@
+#include "pid_tuner.h"
+#include "lemlib/api.hpp" // IWYU pragma: keep
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include "devices.h"
+
+namespace TunerConfig {
+    const char* SETTINGS_FILE = "/usd/pid_gains.txt";
+    const int RELAY_OUTPUT = 40;
+    const int RELAY_CYCLES = 4;
+}
+
+const int TUNE_RATE = 10; // lemlib's control loop rate, in ms
+const double LOOP_SECONDS = TUNE_RATE / 1000.0; // lemlib's derivative is per loop, not per second
+const int WARMUP_CYCLES = 2; // oscillations ignored while the relay settles
+const int RELAY_TIMEOUT = 8000; // longest a relay experiment can run, in ms
+const double LATERAL_HYSTERESIS = 0.25; // inches of error before the relay switches
+const double ANGULAR_HYSTERESIS = 1; // degrees of error before the relay switches
+const int HOLD_TIME = 500; // time spent measuring sensor noise, in ms
+const int SLEW_TIME = 400; // time spent at full power measuring acceleration, in ms
+const double GAIN_SCALES[] = {0.15, 0.25, 0.35}; // fractions of the ultimate gain tried in step trials
+const double LATERAL_STEP = 24; // inches driven in each step trial
+const double ANGULAR_STEP = 90; // degrees turned in each step trial
+const int STEP_TIMEOUT = 3000; // longest a step trial can run, in ms
+
+// Error from a target pose, measured along the target heading for lateral
+double tuneError(const lemlib::Pose& target, bool angular) {
+    lemlib::Pose pose = chassis.getPose();
+    if (angular) {
+        return lemlib::angleError(target.theta, pose.theta, false);
+    }
+    double heading = lemlib::degToRad(target.theta);
+    return (target.x - pose.x) * sin(heading) + (target.y - pose.y) * cos(heading);
+}
+
+// Drives forward for lateral or turns clockwise for angular
+void tuneDrive(double output, bool angular) {
+    left_motors.move(output);
+    right_motors.move(angular ? -output : output);
+}
+
+// Pose a set distance ahead along the current heading, or turned a set amount for angular
+lemlib::Pose tuneTarget(const lemlib::Pose& start, double step, bool angular) {
+    if (angular) {
+        return lemlib::Pose(start.x, start.y, start.theta + step);
+    }
+    double heading = lemlib::degToRad(start.theta);
+    return lemlib::Pose(start.x + step * sin(heading), start.y + step * cos(heading), start.theta);
+}
+
+void tuneMoveTo(const lemlib::Pose& target, bool angular, bool forwards) {
+    if (angular) {
+        chassis.turnToHeading(target.theta, STEP_TIMEOUT, {}, false);
+    } else {
+        chassis.moveToPoint(target.x, target.y, STEP_TIMEOUT, {.forwards = forwards}, false);
+    }
+}
+
+RelayResult runRelayExperiment(bool angular) {
+    RelayResult result = {0, 0, 0, false};
+    lemlib::Pose start = chassis.getPose();
+    double hysteresis = angular ? ANGULAR_HYSTERESIS : LATERAL_HYSTERESIS;
+    double output = TunerConfig::RELAY_OUTPUT;
+
+    int cycles = 0;       // full oscillations seen
+    int measured = 0;     // oscillations counted in the result
+    int lastRise = -1;    // time the relay last switched positive
+    double periodSum = 0, amplitudeSum = 0;
+    double peakMax = -INFINITY, peakMin = INFINITY;
+
+    int startTime = pros::millis(); // Record the start time of the function
+    while (measured < TunerConfig::RELAY_CYCLES && pros::millis() - startTime < RELAY_TIMEOUT) {
+        double error = tuneError(start, angular);
+        peakMax = std::max(peakMax, error);
+        peakMin = std::min(peakMin, error);
+
+        // switching positive marks the end of one oscillation
+        if (output < 0 && error > hysteresis) {
+            output = TunerConfig::RELAY_OUTPUT;
+            int currentTime = pros::millis();
+            if (lastRise >= 0 && ++cycles > WARMUP_CYCLES) {
+                periodSum += currentTime - lastRise;
+                amplitudeSum += (peakMax - peakMin) / 2;
+                measured++;
+            }
+            lastRise = currentTime;
+            peakMax = -INFINITY;
+            peakMin = INFINITY;
+        } else if (output > 0 && error < -hysteresis) {
+            output = -TunerConfig::RELAY_OUTPUT;
+        }
+
+        tuneDrive(output, angular);
+        pros::delay(TUNE_RATE);
+    }
+    left_motors.brake();
+    right_motors.brake();
+
+    // measure how noisy the error is while the robot holds still
+    pros::delay(HOLD_TIME);
+    lemlib::Pose rest = chassis.getPose();
+    double sum = 0, sumSquares = 0;
+    int samples = 0;
+    for (int time = 0; time < HOLD_TIME; time += TUNE_RATE) {
+        double error = tuneError(rest, angular);
+        sum += error;
+        sumSquares += error * error;
+        samples++;
+        pros::delay(TUNE_RATE);
+    }
+    double mean = sum / samples;
+    result.noise = sqrt(std::max(0.0, sumSquares / samples - mean * mean));
+
+    // return to where the experiment started
+    tuneMoveTo(start, angular, tuneError(start, angular) > 0);
+
+    if (measured < TunerConfig::RELAY_CYCLES) {
+        return result;
+    }
+
+    // describing function of a relay with hysteresis
+    double amplitude = amplitudeSum / measured;
+    if (amplitude <= hysteresis) {
+        return result;
+    }
+    result.ultimateGain = 4 * TunerConfig::RELAY_OUTPUT / (M_PI * sqrt(amplitude * amplitude - hysteresis * hysteresis));
+    result.ultimatePeriod = periodSum / measured / 1000;
+    result.valid = true;
+    return result;
+}
+
+// Drives at full power and measures how fast the drivetrain can change speed, in output per loop
+double measureSlew() {
+    lemlib::Pose start = chassis.getPose();
+    double lastDist = 0, speed = 0, maxSpeed = 0, maxAccel = 0;
+
+    for (int time = 0; time < SLEW_TIME; time += TUNE_RATE) {
+        tuneDrive(127, false);
+        pros::delay(TUNE_RATE);
+
+        double dist = -tuneError(start, false);
+        double newSpeed = lemlib::ema((dist - lastDist) / LOOP_SECONDS, speed, 0.5);
+        maxAccel = std::max(maxAccel, (newSpeed - speed) / LOOP_SECONDS);
+        maxSpeed = std::max(maxSpeed, newSpeed);
+        speed = newSpeed;
+        lastDist = dist;
+    }
+    left_motors.brake();
+    right_motors.brake();
+    pros::delay(HOLD_TIME);
+
+    tuneMoveTo(start, false, false);
+
+    if (maxSpeed <= 0) {
+        return 0;
+    }
+    // the output change per loop that matches the fastest the robot can actually accelerate
+    return 127 * maxAccel / maxSpeed * LOOP_SECONDS;
+}
+
+// Runs a step out and back with the given settings and returns how long it took to settle, in ms
+int stepTrial(const lemlib::ControllerSettings& settings, bool angular) {
+    angular ? chassis.setAngularSettings(settings) : chassis.setLateralSettings(settings);
+
+    lemlib::Pose start = chassis.getPose();
+    lemlib::Pose target = tuneTarget(start, angular ? ANGULAR_STEP : LATERAL_STEP, angular);
+    int totalTime = 0;
+
+    for (bool out : {true, false}) {
+        const lemlib::Pose& goal = out ? target : start;
+        int startTime = pros::millis();
+        tuneMoveTo(goal, angular, out);
+        totalTime += pros::millis() - startTime;
+
+        // a step that never got inside the small error range timed out instead of settling
+        if (fabs(tuneError(goal, angular)) > settings.smallError) {
+            totalTime += STEP_TIMEOUT;
+        }
+    }
+    return totalTime;
+}
+
+lemlib::ControllerSettings autotune(bool angular) {
+    lemlib::ControllerSettings current = angular ? chassis.getAngularSettings() : chassis.getLateralSettings();
+    const char* name = angular ? "angular" : "lateral";
+
+    pros::lcd::print(1, "Tuning %s: relay", name);
+    RelayResult relay = runRelayExperiment(angular);
+    if (!relay.valid) {
+        pros::lcd::print(1, "WARN: %s relay never oscillated, keeping gains", name);
+        return current;
+    }
+    std::cout << name << " Ku: " << relay.ultimateGain << " Tu: " << relay.ultimatePeriod
+              << " noise: " << relay.noise << std::endl;
+
+    // exit ranges sit just outside the sensor noise, timeouts scale with how fast the robot responds
+    lemlib::ControllerSettings tuned = current;
+    double minError = angular ? ANGULAR_HYSTERESIS : LATERAL_HYSTERESIS * 2;
+    tuned.kI = 0;
+    tuned.smallError = std::max(minError, 4 * relay.noise);
+    tuned.largeError = 2.5 * tuned.smallError;
+    tuned.smallErrorTimeout = std::max(100.0, relay.ultimatePeriod * 1000 / 4);
+    tuned.largeErrorTimeout = std::max(500.0, relay.ultimatePeriod * 1000 * 2);
+    if (!angular) {
+        pros::lcd::print(1, "Tuning %s: slew", name);
+        tuned.slew = measureSlew();
+    }
+
+    // try a few gains around Ziegler-Nichols PD and keep the one that settles fastest
+    lemlib::ControllerSettings best = current;
+    int bestTime = stepTrial(current, angular);
+    std::cout << name << " current gains settle: " << bestTime << " ms" << std::endl;
+    for (double scale : GAIN_SCALES) {
+        lemlib::ControllerSettings candidate = tuned;
+        candidate.kP = scale * relay.ultimateGain;
+        candidate.kD = candidate.kP * relay.ultimatePeriod / 3 / LOOP_SECONDS;
+
+        pros::lcd::print(1, "Tuning %s: kP %.2f kD %.2f", name, candidate.kP, candidate.kD);
+        int time = stepTrial(candidate, angular);
+        std::cout << name << " kP: " << candidate.kP << " kD: " << candidate.kD
+                  << " settle: " << time << " ms" << std::endl;
+        if (time < bestTime) {
+            bestTime = time;
+            best = candidate;
+        }
+    }
+
+    angular ? chassis.setAngularSettings(best) : chassis.setLateralSettings(best);
+    return best;
+}
+
+lemlib::ControllerSettings autotuneLateral() {
+    return autotune(false);
+}
+
+lemlib::ControllerSettings autotuneAngular() {
+    return autotune(true);
+}
+
+void writeSettings(FILE* file, const char* name, const lemlib::ControllerSettings& settings) {
+    fprintf(file, "%s %f %f %f %f %f %f %f %f %f\n", name, settings.kP, settings.kI, settings.kD,
+            settings.windupRange, settings.smallError, settings.smallErrorTimeout, settings.largeError,
+            settings.largeErrorTimeout, settings.slew);
+}
+
+bool readSettings(FILE* file, const char* name, lemlib::ControllerSettings& settings) {
+    char fileName[16];
+    int count = fscanf(file, "%15s %f %f %f %f %f %f %f %f %f", fileName, &settings.kP, &settings.kI, &settings.kD,
+                       &settings.windupRange, &settings.smallError, &settings.smallErrorTimeout, &settings.largeError,
+                       &settings.largeErrorTimeout, &settings.slew);
+    return count == 10 && strcmp(fileName, name) == 0;
+}
+
+bool saveControllerSettings() {
+    if (!pros::usd::is_installed()) {
+        pros::lcd::print(1, "WARN: No SD card, PID settings not saved");
+        return false;
+    }
+
+    FILE* file = fopen(TunerConfig::SETTINGS_FILE, "w");
+    if (file == nullptr) {
+        return false;
+    }
+    writeSettings(file, "lateral", chassis.getLateralSettings());
+    writeSettings(file, "angular", chassis.getAngularSettings());
+    fclose(file);
+    return true;
+}
+
+bool loadControllerSettings() {
+    if (!pros::usd::is_installed()) {
+        return false;
+    }
+
+    FILE* file = fopen(TunerConfig::SETTINGS_FILE, "r");
+    if (file == nullptr) {
+        return false;
+    }
+    lemlib::ControllerSettings lateral = lateral_controller;
+    lemlib::ControllerSettings angular = angular_controller;
+    bool loaded = readSettings(file, "lateral", lateral) && readSettings(file, "angular", angular);
+    fclose(file);
+
+    // only apply a complete file so a half written one can't leave the controllers mismatched
+    if (loaded) {
+        lateral_controller = lateral;
+        angular_controller = angular;
+        chassis.setLateralSettings(lateral);
+        chassis.setAngularSettings(angular);
+    }
+    return loaded;
+}
+
+void autotunePID(int i) {
+    device_cache.setBrakeMode(all_motors, E_MOTOR_BRAKE_HOLD);
+
+    lateral_controller = autotuneLateral();
+    angular_controller = autotuneAngular();
+    bool saved = saveControllerSettings();
+
+    device_cache.setBrakeMode(all_motors, E_MOTOR_BRAKE_COAST);
+
+    pros::lcd::print(1, "Tuning done, %s", saved ? "saved to SD" : "NOT saved");
+    pros::lcd::print(2, "lat kP %.2f kD %.2f slew %.1f", lateral_controller.kP, lateral_controller.kD, lateral_controller.slew);
+    pros::lcd::print(3, "ang kP %.2f kD %.2f", angular_controller.kP, angular_controller.kD);
+}
@@ -34,12 +34,12 @@ void Piston::handle(bool printing)
         if (buttonPressed)
         {
             // If button is pressed, set piston to opposite of startExtended state
-            startExtended ? this->retract() : this->extend();
+            device_cache.setPiston(*this, !startExtended);
         }
         else
         {
             // If button is not pressed, set piston to startExtended state
-            startExtended ? this->extend() : this->retract();
+            device_cache.setPiston(*this, startExtended);
         }
     }
 
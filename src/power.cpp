@@ -0,0 +1,241 @@
+#include "power.h"
+#include "lemlib/api.hpp" // IWYU pragma: keep
+#include <cstdlib>
+#include "devices.h"
+
+namespace PowerConfig {
+    const int TOTAL_BUDGET = 20000; // the brain's 20 A, eight motors at MAX_LIMIT fit so balanced never throttles a motor
+    const int MAX_LIMIT = 2500;
+    const int MIN_LIMIT = 1000;
+    const int ACTIVE_CURRENT = 300;
+    const int COMMAND_HOLD = 60; // a few updates, long enough for the draw to rise
+    const int LIMIT_DEADBAND = 100;
+    const int UPDATE_RATE = 20; // same as the driver control loop
+}
+
+const double RESTING_CURRENT = 1000; // total mA below which the battery reading counts as resting
+const double RESTING_WEIGHT = 0.05; // ema weight of each resting voltage reading
+
+// Order subsystems claim the budget in for each mode, balanced shares it instead
+const PowerSubsystem PRIORITIES[][static_cast<int>(PowerSubsystem::COUNT)] = {
+    {PowerSubsystem::DRIVE, PowerSubsystem::INTAKE, PowerSubsystem::OC}, // BALANCED
+    {PowerSubsystem::DRIVE, PowerSubsystem::OC, PowerSubsystem::INTAKE}, // DRIVE_PRIORITY
+    {PowerSubsystem::OC, PowerSubsystem::INTAKE, PowerSubsystem::DRIVE}  // SCORING
+};
+
+int PowerManager::motorCount(PowerSubsystem subsystem) {
+    return subsystem == PowerSubsystem::DRIVE ? 6 : 1;
+}
+
+double PowerManager::readDraw(PowerSubsystem subsystem) {
+    // a motor that can't be read counts as drawing nothing
+    auto read = [](std::int32_t current) { return current == PROS_ERR ? 0.0 : current; };
+    switch (subsystem) {
+        case PowerSubsystem::DRIVE: {
+            double total = 0;
+            for (int i = 0; i < 3; i++) {
+                total += read(left_motors.get_current_draw(i)) + read(right_motors.get_current_draw(i));
+            }
+            return total;
+        }
+        case PowerSubsystem::INTAKE:
+            return read(intake.get_current_draw());
+        case PowerSubsystem::OC:
+            return read(oc_motor.get_current_draw());
+        default:
+            return 0;
+    }
+}
+
+void PowerManager::sendLimit(PowerSubsystem subsystem, int limit) {
+    switch (subsystem) {
+        case PowerSubsystem::DRIVE:
+            left_motors.set_current_limit_all(limit);
+            right_motors.set_current_limit_all(limit);
+            break;
+        case PowerSubsystem::INTAKE:
+            intake.set_current_limit(limit);
+            break;
+        case PowerSubsystem::OC:
+            oc_motor.set_current_limit(limit);
+            break;
+        default:
+            break;
+    }
+}
+
+void PowerManager::setMode(PowerMode newMode) {
+    int granted = -1;
+    {
+        std::lock_guard<pros::Mutex> lock(mutex);
+        mode = newMode;
+        if (newMode != PowerMode::BALANCED) {
+            // grant the priority subsystem its max now instead of on the next update
+            granted = static_cast<int>(PRIORITIES[static_cast<int>(newMode)][0]);
+            allocations[granted] = PowerConfig::MAX_LIMIT * motorCount(static_cast<PowerSubsystem>(granted));
+            sentLimits[granted] = PowerConfig::MAX_LIMIT;
+            commandTimes[granted] = pros::millis();
+        }
+    }
+    if (granted >= 0) {
+        sendLimit(static_cast<PowerSubsystem>(granted), PowerConfig::MAX_LIMIT);
+    }
+}
+
+void PowerManager::command(PowerSubsystem subsystem) {
+    std::lock_guard<pros::Mutex> lock(mutex);
+    commandTimes[static_cast<int>(subsystem)] = pros::millis();
+}
+
+PowerMode PowerManager::getMode() {
+    std::lock_guard<pros::Mutex> lock(mutex);
+    return mode;
+}
+
+void PowerManager::update() {
+    TRACE_ZONE("Power");
+    constexpr int count = static_cast<int>(PowerSubsystem::COUNT);
+
+    // read before taking the lock so other tasks aren't held up by the reads
+    double newDraws[count];
+    double totalDraw = 0;
+    for (int i = 0; i < count; i++) {
+        newDraws[i] = readDraw(static_cast<PowerSubsystem>(i));
+        totalDraw += newDraws[i];
+    }
+    double voltage = battery_monitor.getVoltage();
+
+    int changedLimits[count];
+    {
+        std::lock_guard<pros::Mutex> lock(mutex);
+        for (int i = 0; i < count; i++) {
+            draws[i] = newDraws[i];
+        }
+        if (totalDraw < RESTING_CURRENT || restingVoltage == 0) {
+            restingVoltage = restingVoltage == 0 ? voltage : lemlib::ema(voltage, restingVoltage, RESTING_WEIGHT);
+        }
+
+        // everyone gets their minimum first
+        int remaining = PowerConfig::TOTAL_BUDGET;
+        for (int i = 0; i < count; i++) {
+            allocations[i] = PowerConfig::MIN_LIMIT * motorCount(static_cast<PowerSubsystem>(i));
+            remaining -= allocations[i];
+        }
+
+        // what each subsystem wants on top of its minimum, working ones first
+        int now = pros::millis();
+        int wants[count] = {};
+        bool working[count] = {};
+        int totalWant = 0;
+        for (int i = 0; i < count; i++) {
+            PowerSubsystem subsystem = static_cast<PowerSubsystem>(i);
+            int motors = motorCount(subsystem);
+            // a subsystem that was just commanded is working before its draw catches up
+            working[i] = draws[i] > PowerConfig::ACTIVE_CURRENT * motors ||
+                         now - commandTimes[i] < PowerConfig::COMMAND_HOLD;
+            // a rush keeps the intake at its minimum even while it runs
+            bool held = mode == PowerMode::DRIVE_PRIORITY && subsystem == PowerSubsystem::INTAKE;
+            if (!held) {
+                wants[i] = (PowerConfig::MAX_LIMIT - PowerConfig::MIN_LIMIT) * motors;
+                if (working[i]) {
+                    totalWant += wants[i];
+                }
+            }
+        }
+
+        const PowerSubsystem* order = PRIORITIES[static_cast<int>(mode)];
+        if (mode != PowerMode::BALANCED) {
+            // the priority subsystem always gets its max, even past the budget
+            int i = static_cast<int>(order[0]);
+            allocations[i] += wants[i];
+            remaining -= wants[i];
+            if (working[i]) {
+                totalWant -= wants[i];
+            }
+            wants[i] = 0;
+        }
+
+        if (mode == PowerMode::BALANCED && totalWant > remaining) {
+            // share the rest in proportion to what each working one wants
+            for (int i = 0; i < count; i++) {
+                if (working[i]) {
+                    allocations[i] += static_cast<long>(remaining) * wants[i] / totalWant;
+                }
+            }
+            remaining = 0;
+        } else {
+            // fill working subsystems up to the max in priority order
+            for (int j = 0; j < count; j++) {
+                int i = static_cast<int>(order[j]);
+                if (!working[i]) continue;
+                int extra = std::max(0, std::min(remaining, wants[i]));
+                allocations[i] += extra;
+                remaining -= extra;
+            }
+        }
+
+        // idle subsystems get what is left so they don't start out held to their minimum
+        for (int j = 0; j < count; j++) {
+            int i = static_cast<int>(order[j]);
+            if (working[i]) continue;
+            int extra = std::max(0, std::min(remaining, wants[i]));
+            allocations[i] += extra;
+            remaining -= extra;
+        }
+
+        // only resend limits that moved enough to matter
+        for (int i = 0; i < count; i++) {
+            int limit = allocations[i] / motorCount(static_cast<PowerSubsystem>(i));
+            changedLimits[i] = 0;
+            if (sentLimits[i] == 0 || abs(limit - sentLimits[i]) >= PowerConfig::LIMIT_DEADBAND) {
+                sentLimits[i] = limit;
+                changedLimits[i] = limit;
+            }
+        }
+    }
+
+    for (int i = 0; i < count; i++) {
+        if (changedLimits[i] != 0) {
+            sendLimit(static_cast<PowerSubsystem>(i), changedLimits[i]);
+        }
+    }
+}
+
+int PowerManager::getAllocation(PowerSubsystem subsystem) {
+    std::lock_guard<pros::Mutex> lock(mutex);
+    return allocations[static_cast<int>(subsystem)];
+}
+
+int PowerManager::getDraw(PowerSubsystem subsystem) {
+    std::lock_guard<pros::Mutex> lock(mutex);
+    return draws[static_cast<int>(subsystem)];
+}
+
+int PowerManager::getSag() {
+    double voltage = battery_monitor.getVoltage();
+    std::lock_guard<pros::Mutex> lock(mutex);
+    return std::max(0.0, restingVoltage - voltage);
+}
+
+void PowerManager::printTelemetry(int line) {
+    pros::lcd::print(line, "PWR D %d/%d I %d/%d O %d/%d SAG %dmV",
+                     getDraw(PowerSubsystem::DRIVE), getAllocation(PowerSubsystem::DRIVE),
+                     getDraw(PowerSubsystem::INTAKE), getAllocation(PowerSubsystem::INTAKE),
+                     getDraw(PowerSubsystem::OC), getAllocation(PowerSubsystem::OC), getSag());
+}
+
+// measures how late each allocation wakes and how long it runs
+LoopTimer powerTimer("Power", PowerConfig::UPDATE_RATE);
+
+// Task that reallocates the current budget every control cycle
+void power_task(void *param) {
+    std::uint32_t wake = pros::millis();
+    while (true) {
+        powerTimer.recordAge(device_timing.getAge(DataSource::DRIVE));
+        power_manager.update();
+
+        // Wake just after the motors have new current readings
+        wake = device_timing.nextWake(DataSource::DRIVE, wake, PowerConfig::UPDATE_RATE);
+        powerTimer.delayUntil(wake);
+    }
+}
@@ -0,0 +1,177 @@
+#include "resource_monitor.h"
+#include "lemlib/api.hpp" // IWYU pragma: keep
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <malloc.h>
+#include "devices.h"
+
+// libpros is built with INCLUDE_uxTaskGetStackHighWaterMark, the public headers just don't declare it
+extern "C" std::uint32_t uxTaskGetStackHighWaterMark(pros::task_t task);
+
+namespace ResourceConfig {
+    const char* const TASK_NAMES[] = {
+        "Motion Trigger Task",
+        "Auton Runtime Task",
+        "Actuator Scheduler Task",
+        "Geofence Task",
+        "Battery Task",
+        "Thermal Task",
+        "Power Task",
+        "Intake Control Task",
+        "Ring Tracker Task",
+        "Resource Monitor Task",
+        "CPU Monitor Task",
+        "CPU Probe Task",
+        "Device Timing Task",
+        "Device Health Task",
+        "Motor Temp Task",
+        "Calibration Task",
+        "Ring Sens Input Task",
+        "Goal Sens Input Task",
+        // PROS's own competition tasks
+        "User Initialization (PROS)",
+        "User Autonomous (PROS)",
+        "User Operator Control (PROS)"
+    };
+    const int STACK_MARGIN = 256; // 1 KB, a printf with a few doubles can take most of that
+    const int HEAP_GROWTH = 64 * 1024;
+    const int UPDATE_RATE = 1000; // stacks and the heap change slowly, no need to walk them often
+    const int REPORT_RATE = 30000;
+}
+
+static_assert(sizeof(ResourceConfig::TASK_NAMES) / sizeof(ResourceConfig::TASK_NAMES[0]) == ResourceConfig::TASK_COUNT,
+              "TASK_COUNT must match TASK_NAMES");
+
+ResourceMonitor::ResourceMonitor() {
+    for (int& mark : highWater) {
+        mark = -1;
+    }
+}
+
+HeapStats ResourceMonitor::readHeap() {
+    struct mallinfo info = mallinfo();
+    return {static_cast<std::size_t>(info.arena), static_cast<std::size_t>(info.uordblks),
+            static_cast<std::size_t>(info.fordblks), static_cast<std::size_t>(info.keepcost), info.ordblks};
+}
+
+void ResourceMonitor::update() {
+    // read everything before taking the lock, finding tasks briefly suspends the scheduler
+    int marks[ResourceConfig::TASK_COUNT];
+    for (int i = 0; i < ResourceConfig::TASK_COUNT; i++) {
+        pros::task_t task = pros::c::task_get_by_name(ResourceConfig::TASK_NAMES[i]);
+        marks[i] = task == nullptr ? -1 : static_cast<int>(uxTaskGetStackHighWaterMark(task));
+    }
+    HeapStats sample = readHeap();
+
+    // warnings are printed after unlocking
+    const char* tightTask = nullptr;
+    int tightMargin = 0;
+    bool heapGrew = false;
+    {
+        std::lock_guard<pros::Mutex> lock(mutex);
+        for (int i = 0; i < ResourceConfig::TASK_COUNT; i++) {
+            running[i] = marks[i] >= 0;
+            if (!running[i]) continue;
+            highWater[i] = highWater[i] < 0 ? marks[i] : std::min(highWater[i], marks[i]);
+            if (highWater[i] < ResourceConfig::STACK_MARGIN && !stackWarned[i]) {
+                stackWarned[i] = true;
+                tightTask = ResourceConfig::TASK_NAMES[i];
+                tightMargin = highWater[i];
+            }
+        }
+
+        if (heap.arena == 0) {
+            startUsed = sample.used;
+        }
+        heap = sample;
+        if (static_cast<long>(heap.used) - static_cast<long>(startUsed) > ResourceConfig::HEAP_GROWTH && !heapWarned) {
+            heapWarned = true;
+            heapGrew = true;
+        }
+    }
+
+    if (tightTask != nullptr) {
+        pros::lcd::print(1, "WARN: %s has %d words of stack left", tightTask, tightMargin);
+    }
+    if (heapGrew) {
+        pros::lcd::print(1, "WARN: Heap grew %ld KB since startup", getHeapGrowth() / 1024);
+    }
+}
+
+int ResourceMonitor::getHighWater(const char* name) {
+    std::lock_guard<pros::Mutex> lock(mutex);
+    for (int i = 0; i < ResourceConfig::TASK_COUNT; i++) {
+        if (strcmp(ResourceConfig::TASK_NAMES[i], name) == 0) {
+            return highWater[i];
+        }
+    }
+    return -1;
+}
+
+const char* ResourceMonitor::getTightestTask(int& margin) {
+    std::lock_guard<pros::Mutex> lock(mutex);
+    const char* tightest = nullptr;
+    for (int i = 0; i < ResourceConfig::TASK_COUNT; i++) {
+        if (highWater[i] >= 0 && (tightest == nullptr || highWater[i] < margin)) {
+            tightest = ResourceConfig::TASK_NAMES[i];
+            margin = highWater[i];
+        }
+    }
+    return tightest;
+}
+
+HeapStats ResourceMonitor::getHeap() {
+    std::lock_guard<pros::Mutex> lock(mutex);
+    return heap;
+}
+
+long ResourceMonitor::getHeapGrowth() {
+    std::lock_guard<pros::Mutex> lock(mutex);
+    return static_cast<long>(heap.used) - static_cast<long>(startUsed);
+}
+
+void ResourceMonitor::printTelemetry(int line) {
+    int margin = 0;
+    const char* tightest = getTightestTask(margin);
+    HeapStats stats = getHeap();
+    pros::lcd::print(line, "STK %s %d  HEAP %uK +%ldK CHUNKS %d", tightest == nullptr ? "-" : tightest, margin,
+                     static_cast<unsigned>(stats.used / 1024), getHeapGrowth() / 1024, stats.freeChunks);
+}
+
+void ResourceMonitor::printReport() {
+    std::lock_guard<pros::Mutex> lock(mutex);
+    printf("%-30s | %10s | %s\n", "task", "free words", "running");
+    for (int i = 0; i < ResourceConfig::TASK_COUNT; i++) {
+        if (highWater[i] < 0) continue;
+        printf("%-30s | %10d | %s\n", ResourceConfig::TASK_NAMES[i], highWater[i], running[i] ? "yes" : "no");
+    }
+    printf("heap: %u used, %u free in %u arena, %u releasable at top, %d free chunks, %+ld since startup\n",
+           static_cast<unsigned>(heap.used), static_cast<unsigned>(heap.free), static_cast<unsigned>(heap.arena),
+           static_cast<unsigned>(heap.releasable), heap.freeChunks,
+           static_cast<long>(heap.used) - static_cast<long>(startUsed));
+}
+
+// measures how late each stack and heap sample wakes and how long it runs
+LoopTimer resourceMonitorTimer("Resource Monitor", ResourceConfig::UPDATE_RATE);
+
+// Task that samples stacks and the heap
+void resource_monitor_task(void *param) {
+    int lastReport = pros::millis();
+    while (true) {
+        resource_monitor.update();
+
+        if (pros::millis() - lastReport >= ResourceConfig::REPORT_RATE) {
+            resource_monitor.printReport();
+            alloc_tracker.printReport();
+            cpu_monitor.printReport();
+            device_cache.printReport();
+            device_timing.printReport();
+            device_health.printReport();
+            lastReport = pros::millis();
+        }
+
+        // Delay to save resources
+        resourceMonitorTimer.delay();
+    }
+}
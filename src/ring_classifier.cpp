@@ -0,0 +1,321 @@
+#include "ring_classifier.h"
+#include "lemlib/api.hpp" // IWYU pragma: keep
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include "devices.h"
+
+namespace ClassifierConfig {
+    const char* LUT_FILE = "/usd/ring_lut.bin";
+    const char* SAMPLE_FILE = "/usd/ring_samples.csv";
+    const char* CALIBRATION_FILE = "/usd/ring_cal.txt";
+    const int CALIBRATION_TIME = 2000;
+    const double SIGNATURE_DEVIATIONS = 3;
+}
+
+const char LUT_MAGIC[4] = {'R', 'L', 'U', 'T'};
+const int BRIGHTNESS_BITS_PER_BIN = 4; // log2 of the clear channel goes to 16, so each bin is 4 doublings
+const int PREP_TIME = 3000; // time to get the rings in front of the sensor before recording, in ms
+const int RECORD_TIME = 5000; // time each label is recorded for, in ms
+const int RECORD_RATE = 10; // same as the ring sensor's integration time
+
+// floors on learned deviations, a steady venue would otherwise give bands narrower than one table cell
+const double MIN_HUE_DEVIATION = 5;
+const double MIN_PROXIMITY_DEVIATION = 256.0 / ClassifierConfig::PROXIMITY_BINS / 2;
+
+const char* SAMPLE_LABELS[] = {"red", "blue", "none"};
+const char* SAMPLE_PROMPTS[] = {"Hold RED rings at the sensor", "Hold BLUE rings at the sensor", "Keep the intake EMPTY"};
+
+// hue in degrees of a color, -1 if it's gray and has no hue
+double chromaHue(double red, double green, double blue) {
+    double maxChannel = std::max({red, green, blue});
+    double minChannel = std::min({red, green, blue});
+    double chroma = maxChannel - minChannel;
+    if (chroma <= 0) return -1;
+    if (maxChannel == red) return 60 * fmod((green - blue) / chroma + 6, 6);
+    if (maxChannel == green) return 60 * ((blue - red) / chroma + 2);
+    return 60 * ((red - green) / chroma + 4);
+}
+
+// unpack a table cell into the chromaticity at the center of its bins
+void cellCenter(int index, double& red, double& green, double& blue, int& brightnessBin, int& proximityBin) {
+    int greenBin = index % ClassifierConfig::CHROMA_BINS;
+    int redBin = index / ClassifierConfig::CHROMA_BINS % ClassifierConfig::CHROMA_BINS;
+    brightnessBin = index / (ClassifierConfig::CHROMA_BINS * ClassifierConfig::CHROMA_BINS) %
+                    ClassifierConfig::BRIGHTNESS_BINS;
+    proximityBin = index / (ClassifierConfig::CHROMA_BINS * ClassifierConfig::CHROMA_BINS *
+                            ClassifierConfig::BRIGHTNESS_BINS);
+    red = (redBin + 0.5) / ClassifierConfig::CHROMA_BINS;
+    green = (greenBin + 0.5) / ClassifierConfig::CHROMA_BINS;
+    blue = 1 - red - green;
+}
+
+// prompt for red, blue and empty in turn and pass every readable sample along with its label index
+void samplePhases(int recordTime, const std::function<void(int, const pros::c::optical_raw_s_t&, int)>& onSample) {
+    ringSens.set_led_pwm(100); // same brightness as ColorSort runs at
+    for (int label = 0; label < 3; label++) {
+        pros::lcd::print(1, "%s", SAMPLE_PROMPTS[label]);
+        controller.rumble(".");
+        pros::delay(PREP_TIME);
+
+        // move the ring around while recording so every angle and distance is seen
+        pros::lcd::print(2, "Recording %s...", SAMPLE_LABELS[label]);
+        int startTime = pros::millis(); // Record the start time of the function
+        while (pros::millis() - startTime < recordTime) {
+            pros::c::optical_raw_s_t raw = ringSens.get_raw();
+            int proximity = ringSens.get_proximity();
+            if (raw.clear != static_cast<std::uint32_t>(PROS_ERR) && proximity != PROS_ERR) {
+                onSample(label, raw, proximity);
+            }
+            pros::delay(RECORD_RATE);
+        }
+    }
+}
+
+bool RingCalibration::load(const char* path) {
+    FILE* file = fopen(path, "r");
+    if (file == nullptr) {
+        return false;
+    }
+    RingSignature* signatures[] = {&red, &blue, &empty};
+    bool valid = true;
+    for (int label = 0; label < 3 && valid; label++) {
+        char name[16];
+        RingSignature& signature = *signatures[label];
+        valid = fscanf(file, "%15s %lf %lf %lf %lf %d", name, &signature.hue, &signature.hueDeviation,
+                       &signature.proximity, &signature.proximityDeviation, &signature.samples) == 6 &&
+                strcmp(name, SAMPLE_LABELS[label]) == 0;
+    }
+    fclose(file);
+    return valid;
+}
+
+bool RingCalibration::save(const char* path) const {
+    FILE* file = fopen(path, "w");
+    if (file == nullptr) {
+        return false;
+    }
+    const RingSignature* signatures[] = {&red, &blue, &empty};
+    for (int label = 0; label < 3; label++) {
+        const RingSignature& signature = *signatures[label];
+        fprintf(file, "%s %.2f %.2f %.2f %.2f %d\n", SAMPLE_LABELS[label], signature.hue, signature.hueDeviation,
+                signature.proximity, signature.proximityDeviation, signature.samples);
+    }
+    fclose(file);
+    return true;
+}
+
+bool RingClassifier::init() {
+    buildFromHue(RingColor::red.getHue(), RingColor::blue.getHue(), RingConfig::HUE_RANGE,
+                 255 - RingConfig::MAX_RING_DISTANCE);
+    if (!pros::usd::is_installed()) {
+        return false;
+    }
+
+    // a calibration was taken under this venue's lighting, so it wins over a table trained somewhere else
+    RingCalibration calibration;
+    if (calibration.load(ClassifierConfig::CALIBRATION_FILE)) {
+        buildFromCalibration(calibration);
+        return true;
+    }
+    return load(ClassifierConfig::LUT_FILE);
+}
+
+bool RingClassifier::calibrate() {
+    // circular stats for hue, since red sits on both sides of 0
+    double sines[3] = {}, cosines[3] = {}, proximities[3] = {}, proximitySquares[3] = {};
+    int counts[3] = {};
+    samplePhases(ClassifierConfig::CALIBRATION_TIME, [&](int label, const pros::c::optical_raw_s_t& raw, int proximity) {
+        double hue = chromaHue(raw.red, raw.green, raw.blue);
+        if (hue < 0) return;
+        sines[label] += sin(hue * M_PI / 180);
+        cosines[label] += cos(hue * M_PI / 180);
+        proximities[label] += proximity;
+        proximitySquares[label] += static_cast<double>(proximity) * proximity;
+        counts[label]++;
+    });
+
+    RingCalibration calibration;
+    RingSignature* signatures[] = {&calibration.red, &calibration.blue, &calibration.empty};
+    for (int label = 0; label < 3; label++) {
+        if (counts[label] == 0) {
+            pros::lcd::print(1, "WARN: No %s samples, ring calibration kept", SAMPLE_LABELS[label]);
+            return false;
+        }
+        RingSignature& signature = *signatures[label];
+        double length = std::min(hypot(sines[label], cosines[label]) / counts[label], 1.0);
+        signature.hue = fmod(atan2(sines[label], cosines[label]) * 180 / M_PI + 360, 360);
+        signature.hueDeviation = sqrt(-2 * log(std::max(length, 1e-9))) * 180 / M_PI;
+        signature.proximity = proximities[label] / counts[label];
+        signature.proximityDeviation =
+            sqrt(std::max(proximitySquares[label] / counts[label] - signature.proximity * signature.proximity, 0.0));
+        signature.samples = counts[label];
+    }
+
+    buildFromCalibration(calibration);
+    if (!calibration.save(ClassifierConfig::CALIBRATION_FILE)) {
+        pros::lcd::print(1, "WARN: Ring calibration not saved to SD");
+    }
+    pros::lcd::print(1, "Red %.0f+-%.0f Blue %.0f+-%.0f", calibration.red.hue, calibration.red.hueDeviation,
+                     calibration.blue.hue, calibration.blue.hueDeviation);
+    pros::lcd::print(2, "Ring calibration done");
+    return true;
+}
+
+int RingClassifier::cellIndex(const pros::c::optical_raw_s_t& raw, int proximity) {
+    if (raw.clear == static_cast<std::uint32_t>(PROS_ERR) || proximity == PROS_ERR) {
+        return -1;
+    }
+
+    // chromaticity, so a dim and a bright ring of the same color land in the same cells
+    double sum = static_cast<double>(raw.red) + raw.green + raw.blue;
+    double red = sum > 0 ? raw.red / sum : 1.0 / 3;
+    double green = sum > 0 ? raw.green / sum : 1.0 / 3;
+    int redBin = std::min(static_cast<int>(red * ClassifierConfig::CHROMA_BINS), ClassifierConfig::CHROMA_BINS - 1);
+    int greenBin = std::min(static_cast<int>(green * ClassifierConfig::CHROMA_BINS), ClassifierConfig::CHROMA_BINS - 1);
+
+    int brightnessBin = std::min(static_cast<int>(log2(raw.clear + 1.0)) / BRIGHTNESS_BITS_PER_BIN,
+                                 ClassifierConfig::BRIGHTNESS_BINS - 1);
+    int proximityBin = std::clamp(proximity * ClassifierConfig::PROXIMITY_BINS / 256, 0,
+                                  ClassifierConfig::PROXIMITY_BINS - 1);
+
+    return ((proximityBin * ClassifierConfig::BRIGHTNESS_BINS + brightnessBin) * ClassifierConfig::CHROMA_BINS +
+            redBin) * ClassifierConfig::CHROMA_BINS + greenBin;
+}
+
+void RingClassifier::buildFromHue(double redHue, double blueHue, double range, int minProximity) {
+    for (int index = 0; index < ClassifierConfig::TABLE_SIZE; index++) {
+        double red, green, blue;
+        int brightnessBin, proximityBin;
+        cellCenter(index, red, green, blue, brightnessBin, proximityBin);
+
+        // a ring has to be close and lit enough to read, and chromaticities can't add to more than 1
+        bool close = (proximityBin + 1) * 256 / ClassifierConfig::PROXIMITY_BINS > minProximity;
+        double hue = chromaHue(red, green, blue);
+        if (!close || brightnessBin == 0 || blue < 0 || hue < 0) {
+            table[index] = static_cast<std::uint8_t>(RingClass::EMPTY);
+            continue;
+        }
+
+        auto near = [&](double center) { return fabs(lemlib::angleError(hue, center, false)) <= range; };
+        RingClass ringClass = near(redHue) ? RingClass::RED : near(blueHue) ? RingClass::BLUE : RingClass::EMPTY;
+        table[index] = static_cast<std::uint8_t>(ringClass);
+    }
+}
+
+void RingClassifier::buildFromCalibration(const RingCalibration& calibration) {
+    for (int index = 0; index < ClassifierConfig::TABLE_SIZE; index++) {
+        double red, green, blue;
+        int brightnessBin, proximityBin;
+        cellCenter(index, red, green, blue, brightnessBin, proximityBin);
+        double hue = chromaHue(red, green, blue);
+        if (brightnessBin == 0 || blue < 0 || hue < 0) {
+            table[index] = static_cast<std::uint8_t>(RingClass::EMPTY);
+            continue;
+        }
+
+        // how many standard deviations the cell center is from a signature
+        double proximity = (proximityBin + 0.5) * 256 / ClassifierConfig::PROXIMITY_BINS;
+        auto distance = [&](const RingSignature& signature) {
+            return hypot(lemlib::angleError(hue, signature.hue, false) /
+                             std::max(signature.hueDeviation, MIN_HUE_DEVIATION),
+                         (proximity - signature.proximity) /
+                             std::max(signature.proximityDeviation, MIN_PROXIMITY_DEVIATION));
+        };
+        double redDistance = distance(calibration.red);
+        double blueDistance = distance(calibration.blue);
+        double emptyDistance = distance(calibration.empty);
+
+        RingClass ringClass = RingClass::EMPTY;
+        if (redDistance <= ClassifierConfig::SIGNATURE_DEVIATIONS && redDistance < blueDistance &&
+            redDistance < emptyDistance) {
+            ringClass = RingClass::RED;
+        }
+        else if (blueDistance <= ClassifierConfig::SIGNATURE_DEVIATIONS && blueDistance < redDistance &&
+                 blueDistance < emptyDistance) {
+            ringClass = RingClass::BLUE;
+        }
+        table[index] = static_cast<std::uint8_t>(ringClass);
+    }
+}
+
+bool RingClassifier::load(const char* path) {
+    FILE* file = fopen(path, "rb");
+    if (file == nullptr) {
+        return false;
+    }
+
+    // check the table was trained with the same bins before replacing anything
+    char magic[4];
+    std::uint8_t dims[4];
+    std::uint8_t loaded[ClassifierConfig::TABLE_SIZE];
+    bool valid = fread(magic, 1, 4, file) == 4 && memcmp(magic, LUT_MAGIC, 4) == 0 &&
+                 fread(dims, 1, 4, file) == 4 && dims[0] == ClassifierConfig::CHROMA_BINS &&
+                 dims[1] == ClassifierConfig::CHROMA_BINS && dims[2] == ClassifierConfig::BRIGHTNESS_BINS &&
+                 dims[3] == ClassifierConfig::PROXIMITY_BINS &&
+                 fread(loaded, 1, ClassifierConfig::TABLE_SIZE, file) == ClassifierConfig::TABLE_SIZE;
+    fclose(file);
+
+    if (!valid) {
+        pros::lcd::print(1, "WARN: Ring lookup table on SD doesn't match, using hues");
+        return false;
+    }
+    memcpy(table, loaded, ClassifierConfig::TABLE_SIZE);
+    return true;
+}
+
+bool RingClassifier::save(const char* path) const {
+    FILE* file = fopen(path, "wb");
+    if (file == nullptr) {
+        return false;
+    }
+    std::uint8_t dims[4] = {ClassifierConfig::CHROMA_BINS, ClassifierConfig::CHROMA_BINS,
+                            ClassifierConfig::BRIGHTNESS_BINS, ClassifierConfig::PROXIMITY_BINS};
+    bool saved = fwrite(LUT_MAGIC, 1, 4, file) == 4 && fwrite(dims, 1, 4, file) == 4 &&
+                 fwrite(table, 1, ClassifierConfig::TABLE_SIZE, file) == ClassifierConfig::TABLE_SIZE;
+    fclose(file);
+    return saved;
+}
+
+void RingClassifier::setCell(int index, RingClass ringClass) {
+    if (index >= 0 && index < ClassifierConfig::TABLE_SIZE) {
+        table[index] = static_cast<std::uint8_t>(ringClass);
+    }
+}
+
+RingClass RingClassifier::classify(const pros::c::optical_raw_s_t& raw, int proximity) const {
+    int index = cellIndex(raw, proximity);
+    return index < 0 ? RingClass::EMPTY : static_cast<RingClass>(table[index]);
+}
+
+RingClass RingClassifier::sample() const {
+    // a faulted sensor reads PROS_ERR, which could land in any cell
+    if (!device_health.isHealthy(ringSens.get_port())) {
+        return RingClass::EMPTY;
+    }
+    return classify(ringSens.get_raw(), ringSens.get_proximity());
+}
+
+void recordRingSamples(int i) {
+    if (!pros::usd::is_installed()) {
+        pros::lcd::print(1, "WARN: No SD card, ring samples not recorded");
+        return;
+    }
+    FILE* file = fopen(ClassifierConfig::SAMPLE_FILE, "w");
+    if (file == nullptr) {
+        return;
+    }
+    fprintf(file, "label,clear,red,green,blue,proximity\n");
+
+    int count = 0;
+    samplePhases(RECORD_TIME, [&](int label, const pros::c::optical_raw_s_t& raw, int proximity) {
+        fprintf(file, "%s,%lu,%lu,%lu,%lu,%d\n", SAMPLE_LABELS[label], static_cast<unsigned long>(raw.clear),
+                static_cast<unsigned long>(raw.red), static_cast<unsigned long>(raw.green),
+                static_cast<unsigned long>(raw.blue), proximity);
+        count++;
+    });
+    fclose(file);
+    pros::lcd::print(1, "Recorded %d ring samples", count);
+    pros::lcd::print(2, "Train with tools/ring_lut_train");
+}
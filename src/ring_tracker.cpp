@@ -0,0 +1,189 @@
+#include "ring_tracker.h"
+#include "lemlib/api.hpp" // IWYU pragma: keep
+#include <cstdlib>
+#include "devices.h"
+
+namespace RingTrackerConfig {
+    const int SAMPLE_RATE = 10; // motors and the optical sensor at 10 ms integration both report every 10 ms
+    const double RUNNING_VELOCITY = 200;
+    const double CURRENT_RISE = 400;
+    const double VELOCITY_DIP = 0.15;
+    const int MIN_DIP_TIME = 20;
+    const int MAX_DIP_TIME = 300; // past this the intake controller handles it as a jam
+    const int REFRACTORY_TIME = 200;
+    const int FUSION_WINDOW = 150;
+    const int THROUGHPUT_WINDOW = 3000;
+}
+
+const double BASELINE_WEIGHT = 0.05; // ema weight of free running samples, slow so a ring barely moves it
+const int WAIT_RATE = 10; // time between checks while waiting for a ring, in ms
+
+void RingTracker::addDetection(int time, RingSource source, RingEventColor color) {
+    std::lock_guard<pros::Mutex> lock(mutex);
+
+    // the other detector may have already seen this ring
+    if (eventCount > 0) {
+        RingEvent& last = events[(eventCount - 1) % RingTrackerConfig::MAX_EVENTS];
+        if (!(last.sources & source) && abs(time - last.time) <= RingTrackerConfig::FUSION_WINDOW) {
+            last.sources |= source;
+            last.time = std::min(last.time, time);
+            if (color != RingEventColor::UNKNOWN) {
+                last.color = color;
+            }
+            return;
+        }
+    }
+
+    events[eventCount % RingTrackerConfig::MAX_EVENTS] = {time, source, color};
+    eventCount++;
+}
+
+void RingTracker::updateCurrent(int time) {
+    double velocity = intake.get_actual_velocity();
+    std::int32_t current = intake.get_current_draw();
+    if (velocity == PROS_ERR_F || current == PROS_ERR) {
+        return;
+    }
+
+    // only look for rings while intaking at speed, starting and stopping look like dips
+    bool running = velocity > RingTrackerConfig::RUNNING_VELOCITY * (1 - RingTrackerConfig::VELOCITY_DIP);
+    // a dip longer than a ring is a slowdown, outtake or jam, so drop it and learn the new speed
+    bool tooLong = dipStart >= 0 && time - dipStart > RingTrackerConfig::MAX_DIP_TIME;
+    if (!running || tooLong) {
+        dipStart = -1;
+        baseCurrent = 0;
+        baseVelocity = 0;
+        return;
+    }
+    if (baseVelocity == 0) {
+        if (velocity < RingTrackerConfig::RUNNING_VELOCITY) return;
+        baseCurrent = current;
+        baseVelocity = velocity;
+        return;
+    }
+
+    bool dipping = current > baseCurrent + RingTrackerConfig::CURRENT_RISE ||
+                   velocity < baseVelocity * (1 - RingTrackerConfig::VELOCITY_DIP);
+    if (dipping) {
+        if (dipStart < 0) {
+            dipStart = time;
+        }
+        return;
+    }
+
+    // a dip just ended, count it if it was the length of a ring rather than noise or a jam
+    if (dipStart >= 0) {
+        int length = time - dipStart;
+        bool ready = lastCurrentRing < 0 || dipStart - lastCurrentRing >= RingTrackerConfig::REFRACTORY_TIME;
+        if (length >= RingTrackerConfig::MIN_DIP_TIME && length <= RingTrackerConfig::MAX_DIP_TIME && ready) {
+            lastCurrentRing = dipStart;
+            addDetection(dipStart, RING_SOURCE_CURRENT, RingEventColor::UNKNOWN);
+        }
+        dipStart = -1;
+    }
+
+    // free running, so track slow changes like battery sag
+    baseCurrent = lemlib::ema(current, baseCurrent, BASELINE_WEIGHT);
+    baseVelocity = lemlib::ema(velocity, baseVelocity, BASELINE_WEIGHT);
+}
+
+void RingTracker::updateOptical(int time) {
+    std::int32_t proximity = ringSens.get_proximity();
+    if (proximity == PROS_ERR) {
+        return;
+    }
+
+    // a ring counts once on the way into view
+    bool inView = proximity > 255 - RingConfig::MAX_RING_DISTANCE;
+    if (inView && !ringInView) {
+        bool ready = lastOpticalRing < 0 || time - lastOpticalRing >= RingTrackerConfig::REFRACTORY_TIME;
+        if (ready) {
+            RingClass ringClass = ring_classifier.sample();
+            RingEventColor color = ringClass == RingClass::RED    ? RingEventColor::RED
+                                   : ringClass == RingClass::BLUE ? RingEventColor::BLUE
+                                                                  : RingEventColor::UNKNOWN;
+            lastOpticalRing = time;
+            addDetection(time, RING_SOURCE_OPTICAL, color);
+        }
+    }
+    ringInView = inView;
+}
+
+void RingTracker::update() {
+    TRACE_ZONE("Ring Tracker");
+    int time = pros::millis();
+    updateCurrent(time);
+    updateOptical(time);
+}
+
+int RingTracker::getRingCount() {
+    std::lock_guard<pros::Mutex> lock(mutex);
+    return eventCount;
+}
+
+double RingTracker::getThroughput() {
+    std::lock_guard<pros::Mutex> lock(mutex);
+    int since = pros::millis() - RingTrackerConfig::THROUGHPUT_WINDOW;
+    int count = 0;
+    int kept = std::min(eventCount, RingTrackerConfig::MAX_EVENTS);
+    for (int i = 1; i <= kept; i++) {
+        if (events[(eventCount - i) % RingTrackerConfig::MAX_EVENTS].time < since) break;
+        count++;
+    }
+    return count * 1000.0 / RingTrackerConfig::THROUGHPUT_WINDOW;
+}
+
+bool RingTracker::getLastEvent(RingEvent& event) {
+    std::lock_guard<pros::Mutex> lock(mutex);
+    if (eventCount == 0) {
+        return false;
+    }
+    event = events[(eventCount - 1) % RingTrackerConfig::MAX_EVENTS];
+    return true;
+}
+
+int RingTracker::getEvents(RingEvent* out, int max) {
+    std::lock_guard<pros::Mutex> lock(mutex);
+    int count = std::min({eventCount, RingTrackerConfig::MAX_EVENTS, max});
+    for (int i = 0; i < count; i++) {
+        out[i] = events[(eventCount - count + i) % RingTrackerConfig::MAX_EVENTS];
+    }
+    return count;
+}
+
+bool RingTracker::waitForRing(int msecTimeout) {
+    int startTime = pros::millis(); // Record the start time of the function
+    int startCount = getRingCount();
+    while (pros::millis() - startTime < msecTimeout) {
+        if (getRingCount() != startCount) {
+            return true;
+        }
+        pros::delay(WAIT_RATE);
+    }
+    return false;
+}
+
+void RingTracker::reset() {
+    std::lock_guard<pros::Mutex> lock(mutex);
+    eventCount = 0;
+}
+
+// measures how late each sample wakes and how long it runs
+LoopTimer ringTrackerTimer("Ring Tracker", RingTrackerConfig::SAMPLE_RATE);
+
+// Task that samples the intake and ring sensor for rings
+void ring_tracker_task(void *param) {
+    LoopGuard guard("Ring Tracker");
+    std::uint32_t wake = pros::millis();
+    while (true) {
+        // a count is only as fresh as the older of the two readings it used
+        ringTrackerTimer.recordAge(std::max(device_timing.getAge(DataSource::RING_SENSOR),
+                                            device_timing.getAge(DataSource::INTAKE, false)));
+        ring_tracker.update();
+        guard.tick();
+
+        // Wake just after the ring sensor has a new reading
+        wake = device_timing.nextWake(DataSource::RING_SENSOR, wake, RingTrackerConfig::SAMPLE_RATE);
+        ringTrackerTimer.delayUntil(wake);
+    }
+}
@@ -0,0 +1,199 @@
+#include "sysid.h"
+#include "lemlib/api.hpp" // IWYU pragma: keep
+#include <cstdlib>
+#include <iostream>
+#include "devices.h"
+
+namespace SysidConfig {
+    const char* LOG_FILE = "/usd/sysid.csv";
+    const int SAMPLE_RATE = 5;
+    const int RAMP_RATE = 1000; // 1 V per second
+    const int RAMP_TIME = 3000;
+    const int STEP_VOLTAGE = 6000;
+    const int STEP_TIME = 1000;
+    const double MIN_VELOCITY = 0.5;
+}
+
+const double CARTRIDGE_RPM = 600; // blue cartridges on the drivetrain
+const double ACCEL_SMOOTHING = 0.3; // ema weight of each new acceleration sample
+const int REST_TIME = 500; // time to let the drivetrain stop between tests, in ms
+
+// Average wheel speed of a side in inches per second from the motor encoders
+double sideVelocity(pros::MotorGroup& motors) {
+    std::vector<double> velocities = motors.get_actual_velocity_all();
+    if (velocities.empty()) {
+        return 0;
+    }
+    double rpm = 0;
+    for (double velocity : velocities) {
+        rpm += velocity;
+    }
+    rpm /= velocities.size();
+    return rpm * drivetrain.rpm / CARTRIDGE_RPM * drivetrain.wheelDiameter * M_PI / 60;
+}
+
+int runSysidTest(SysidTest test, bool angular, bool forwards, SysidSample* samples, int maxSamples) {
+    int duration = test == SysidTest::QUASISTATIC ? SysidConfig::RAMP_TIME : SysidConfig::STEP_TIME;
+    double direction = forwards ? 1 : -1;
+    double lastVelocity = 0, acceleration = 0;
+    int count = 0;
+
+    int startTime = pros::millis(); // Record the start time of the function
+    int lastTime = startTime;
+    while (pros::millis() - startTime < duration && count < maxSamples) {
+        int currentTime = pros::millis();
+        double voltage = test == SysidTest::QUASISTATIC ? SysidConfig::RAMP_RATE * (currentTime - startTime) / 1000.0
+                                                        : SysidConfig::STEP_VOLTAGE;
+        voltage *= direction;
+        left_motors.move_voltage(voltage);
+        right_motors.move_voltage(angular ? -voltage : voltage);
+
+        // turning measures each side in its own direction so both tests fit the same side model
+        double left = sideVelocity(left_motors);
+        double right = sideVelocity(right_motors);
+        double velocity = angular ? (left - right) / 2 : (left + right) / 2;
+        if (currentTime > lastTime) {
+            double rawAcceleration = (velocity - lastVelocity) * 1000 / (currentTime - lastTime);
+            acceleration = lemlib::ema(rawAcceleration, acceleration, ACCEL_SMOOTHING);
+        }
+        lastVelocity = velocity;
+        lastTime = currentTime;
+
+        samples[count++] = {static_cast<std::uint32_t>(currentTime - startTime), static_cast<float>(voltage),
+                            static_cast<float>(velocity), static_cast<float>(acceleration)};
+        pros::delay(SysidConfig::SAMPLE_RATE);
+    }
+    left_motors.move_voltage(0);
+    right_motors.move_voltage(0);
+    pros::delay(REST_TIME);
+    return count;
+}
+
+Feedforward fitFeedforward(const SysidSample* samples, int count) {
+    Feedforward result = {0, 0, 0, 0, 0, false};
+
+    // normal equations of voltage = kS * sign(v) + kV * v + kA * a
+    double matrix[3][4] = {};
+    double voltageSum = 0, voltageSquares = 0;
+    for (int i = 0; i < count; i++) {
+        if (fabs(samples[i].velocity) < SysidConfig::MIN_VELOCITY) continue;
+
+        double row[3] = {samples[i].velocity > 0 ? 1.0 : -1.0, samples[i].velocity, samples[i].acceleration};
+        for (int r = 0; r < 3; r++) {
+            for (int c = 0; c < 3; c++) {
+                matrix[r][c] += row[r] * row[c];
+            }
+            matrix[r][3] += row[r] * samples[i].voltage;
+        }
+        voltageSum += samples[i].voltage;
+        voltageSquares += samples[i].voltage * samples[i].voltage;
+        result.samples++;
+    }
+    if (result.samples < 10) {
+        return result;
+    }
+
+    // gaussian elimination with partial pivoting
+    for (int col = 0; col < 3; col++) {
+        int pivot = col;
+        for (int r = col + 1; r < 3; r++) {
+            if (fabs(matrix[r][col]) > fabs(matrix[pivot][col])) pivot = r;
+        }
+        if (fabs(matrix[pivot][col]) < 1e-9) {
+            return result;
+        }
+        std::swap(matrix[col], matrix[pivot]);
+        for (int r = 0; r < 3; r++) {
+            if (r == col) continue;
+            double factor = matrix[r][col] / matrix[col][col];
+            for (int c = col; c < 4; c++) {
+                matrix[r][c] -= factor * matrix[col][c];
+            }
+        }
+    }
+    result.kS = matrix[0][3] / matrix[0][0];
+    result.kV = matrix[1][3] / matrix[1][1];
+    result.kA = matrix[2][3] / matrix[2][2];
+
+    // r squared from the residuals of the fit
+    double residualSquares = 0;
+    for (int i = 0; i < count; i++) {
+        if (fabs(samples[i].velocity) < SysidConfig::MIN_VELOCITY) continue;
+        double residual = samples[i].voltage - feedforwardVoltage(result, samples[i].velocity, samples[i].acceleration);
+        residualSquares += residual * residual;
+    }
+    double mean = voltageSum / result.samples;
+    double totalSquares = voltageSquares - result.samples * mean * mean;
+    result.rSquared = totalSquares > 0 ? 1 - residualSquares / totalSquares : 0;
+    result.valid = result.kV > 0 && result.kA >= 0;
+    return result;
+}
+
+double feedforwardVoltage(const Feedforward& feedforward, double velocity, double acceleration) {
+    double sign = velocity > 0 ? 1 : velocity < 0 ? -1 : 0;
+    double voltage = feedforward.kS * sign + feedforward.kV * velocity + feedforward.kA * acceleration;
+    return std::clamp(voltage, -12000.0, 12000.0);
+}
+
+void writeSysidSamples(FILE* file, bool angular, SysidTest test, bool forwards, const SysidSample* samples,
+                       int count) {
+    const char* motion = angular ? "angular" : "linear";
+    const char* testName = test == SysidTest::QUASISTATIC ? "quasistatic" : "dynamic";
+    const char* direction = forwards ? "forward" : "reverse";
+    for (int i = 0; i < count; i++) {
+        fprintf(file, "%s,%s,%s,%lu,%.0f,%.3f,%.3f\n", motion, testName, direction,
+                static_cast<unsigned long>(samples[i].time), samples[i].voltage, samples[i].velocity,
+                samples[i].acceleration);
+    }
+}
+
+// Runs all four tests of one motion, logs them and fits them together
+Feedforward characterize(bool angular, FILE* log) {
+    // static so the samples don't need to fit on the task stack
+    static SysidSample samples[4 * SysidConfig::MAX_SAMPLES];
+    const char* name = angular ? "angular" : "linear";
+    int count = 0;
+
+    for (SysidTest test : {SysidTest::QUASISTATIC, SysidTest::DYNAMIC}) {
+        // forward then reverse so the robot ends up about where it started
+        for (bool forwards : {true, false}) {
+            pros::lcd::print(1, "Sysid %s %s %s", name, test == SysidTest::QUASISTATIC ? "ramp" : "step",
+                             forwards ? "forward" : "reverse");
+            int recorded = runSysidTest(test, angular, forwards, samples + count, SysidConfig::MAX_SAMPLES);
+            if (log != nullptr) {
+                writeSysidSamples(log, angular, test, forwards, samples + count, recorded);
+            }
+            count += recorded;
+        }
+    }
+
+    Feedforward feedforward = fitFeedforward(samples, count);
+    std::cout << name << " kS: " << feedforward.kS << " kV: " << feedforward.kV << " kA: " << feedforward.kA
+              << " r2: " << feedforward.rSquared << " samples: " << feedforward.samples << std::endl;
+    return feedforward;
+}
+
+void runSysid(int i) {
+    FILE* log = nullptr;
+    if (pros::usd::is_installed()) {
+        log = fopen(SysidConfig::LOG_FILE, "w");
+    }
+    if (log == nullptr) {
+        pros::lcd::print(1, "WARN: No SD card, sysid samples not logged");
+    } else {
+        fprintf(log, "motion,test,direction,time,voltage,velocity,acceleration\n");
+    }
+
+    device_cache.setBrakeMode(all_motors, E_MOTOR_BRAKE_COAST);
+    Feedforward linear = characterize(false, log);
+    Feedforward angular = characterize(true, log);
+    if (log != nullptr) {
+        fclose(log);
+    }
+
+    pros::lcd::print(1, "Sysid done, %s", log != nullptr ? "logged to SD" : "NOT logged");
+    pros::lcd::print(2, "lin kS %.0f kV %.1f kA %.2f r2 %.2f%s", linear.kS, linear.kV, linear.kA, linear.rSquared,
+                     linear.valid ? "" : " BAD");
+    pros::lcd::print(3, "ang kS %.0f kV %.1f kA %.2f r2 %.2f%s", angular.kS, angular.kV, angular.kA,
+                     angular.rSquared, angular.valid ? "" : " BAD");
+}
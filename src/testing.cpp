@@ -10,6 +10,7 @@
 #include <cstdlib>
 #include "devices.h"
 #include "auton_routes.h"
+#include "pid_tuner.h"
 #include <iomanip>
 
 /*void testCombinedPID()
@@ -103,16 +104,16 @@ void testRingSens(int i)
             }
             pros::delay(20);
         }
-    });
+    }, "Ring Sens Input Task");
 
     while (true)
     {
 
-        intake.move(intakeVelocity);
+        device_cache.move(intake, intakeVelocity);
         pros::lcd::clear_line(1);
         pros::lcd::print(1, "Waiting for red...");
         color_sort.waitUntilDetected(100000,RingColor::red);
-        intake.brake();
+        device_cache.brake(intake);
         pros::lcd::clear_line(1);
         if(color_sort.isDetected(RingColor::red)){
             pros::lcd::print(1, "Got red!");
@@ -122,11 +123,11 @@ void testRingSens(int i)
         }
         endSection(1000000);
 
-        intake.move(intakeVelocity);
+        device_cache.move(intake, intakeVelocity);
         pros::lcd::clear_line(1);
         pros::lcd::print(1, "Waiting for blue...");
         color_sort.waitUntilDetected(100000,RingColor::blue);
-        intake.brake();
+        device_cache.brake(intake);
         pros::lcd::clear_line(1);
         if(color_sort.isDetected(RingColor::blue)){
             pros::lcd::print(1, "Got blue!");
@@ -156,14 +157,14 @@ void testGoalSens(int i)
             }
             pros::delay(20);
         }
-    });
+    }, "Goal Sens Input Task");
     while (true)
     {
-        all_motors.set_brake_mode(E_MOTOR_BRAKE_COAST);
+        device_cache.setBrakeMode(all_motors, E_MOTOR_BRAKE_COAST);
         pros::lcd::clear_line(1);
         pros::lcd::print(1, "Waiting for goal...");
         all_motors.move_velocity(driveVelocity);
-        auto_clamp.waitUntilClamp(100, 1000);
+        auto_clamp.waitUntilClampPredictive(100, 1000);
         all_motors.brake();
         pros::lcd::clear_line(1);
         if(auto_clamp.isGoalClamped()){
@@ -176,13 +177,16 @@ void testGoalSens(int i)
     }
 }
 
+// measures how much of the CPU reading the motors and reprinting the screen takes
+LoopTimer motorTempTimer("Motor Temp", 200);
+
 void motor_temp_task(void* param){
 
     int lastTorqueTimestamp = pros::millis();
     int torqueTimeout = 2000;
     int lastTorque = (int)intake.get_torque();
     while(true){
-        pros::delay(200);
+        motorTempTimer.delay();
 
         // Array of motor names
         const char* motorNames[] = {"LM1", "LM2", "LM3", "RM1", "RM2", "RM3", "INT"};
@@ -212,11 +216,19 @@ void motor_temp_task(void* param){
         pros::lcd::print(2, "TEMP: %d  %d  %d  %d  %d  %d  %d", (int)motorTemps[0], (int)motorTemps[1], (int)motorTemps[2], (int)motorTemps[3], (int)motorTemps[4], (int)motorTemps[5], (int)motorTemps[6]);
         //pros::lcd::print(3, "EFF%: %d  %d  %d  %d  %d  %d  %d", (int)motorEfficiencies[0], (int)motorEfficiencies[1], (int)motorEfficiencies[2], (int)motorEfficiencies[3], (int)motorEfficiencies[4], (int)motorEfficiencies[5], (int)motorEfficiencies[6]);
         //pros::lcd::print(3,"EFF: %f", left_motors.get_efficiency(0));
-        // Print Meaning
-        pros::lcd::print(4, "Temp >= 55 is Overheating");
+        // Print how long the hottest drive motor has before it throttles
+        int timeToThrottle = thermal_monitor.getDriveTimeToThrottle();
+        pros::lcd::print(3, "DRIVE BUDGET: %d%%  THROTTLE: %s", (int)(thermal_monitor.getDriveBudget() * 100),
+                         timeToThrottle < 0 ? "never" : std::to_string(timeToThrottle / 1000).append("s").c_str());
+        // Print total CPU load, the busiest loop and what the loops don't account for
+        cpu_monitor.printTelemetry(4);
 
         // Print battery percentage
         pros::lcd::print(5, "Battery: %.2f%%", pros::battery::get_capacity());
+        // Print how the current budget is split and how far the battery has sagged
+        power_manager.printTelemetry(7);
+        // Print the task closest to overflowing its stack and how the heap has grown
+        resource_monitor.printTelemetry(0);
 
         // Print max intake torque in last X time
         if(pros::millis() - lastTorqueTimestamp > torqueTimeout || intake.get_torque() > lastTorque){
@@ -261,8 +273,8 @@ void testAuton(bool inputReq)
         endSection();
 
         // sets motor brake type to hold (standard for auton)
-        left_motors.set_brake_mode_all(E_MOTOR_BRAKE_HOLD);
-        right_motors.set_brake_mode_all(E_MOTOR_BRAKE_HOLD);
+        device_cache.setBrakeMode(left_motors, E_MOTOR_BRAKE_HOLD);
+        device_cache.setBrakeMode(right_motors, E_MOTOR_BRAKE_HOLD);
 
         oc_piston.set_value(LOW);
         clamp.retract();
@@ -287,13 +299,20 @@ void testAuton(bool inputReq)
         left_motors.brake();
         right_motors.brake();
 
+        // report how on time the scheduled actuator commands were
+        actuator_scheduler.printJitter();
+        actuator_scheduler.resetJitter();
+        // report how the periodic loops kept up while the route ran
+        dumpLoopTimers(stdout);
+        dumpTrace(); // no-op unless built with TRACE=1
+
         // small delay to make sure robot is still
         delay(2000);
 
         // sets motor brake type to coast (standard for usercontrol)
-        intake.brake();
-        left_motors.set_brake_mode_all(E_MOTOR_BRAKE_COAST);
-        right_motors.set_brake_mode_all(E_MOTOR_BRAKE_COAST);
+        device_cache.brake(intake);
+        device_cache.setBrakeMode(left_motors, E_MOTOR_BRAKE_COAST);
+        device_cache.setBrakeMode(right_motors, E_MOTOR_BRAKE_COAST);
     }
 }
 
@@ -366,15 +385,17 @@ void tunePID()
             }
             switch (currentConst)
             {
-            case 1:
+            case 0:
                 PID.kP += deltaVal;
                 cout << "kP: " << PID.kP << endl;
                 break;
-            case 2:
+            case 1:
                 PID.kI += deltaVal;
+                cout << "kI: " << PID.kI << endl;
                 break;
-            case 3:
+            case 2:
                 PID.kD += deltaVal;
+                cout << "kD: " << PID.kD << endl;
                 break;
             }
 
@@ -399,5 +420,14 @@ void tunePID()
             }
             updateController(currentConst, valMag, PID);
         }
+
+        if (controller.get_digital_new_press(E_CONTROLLER_DIGITAL_A))
+        { // Applies the tuned values to the chassis and saves them
+            lateral_controller = PID;
+            chassis.setLateralSettings(PID);
+            cout << (saveControllerSettings() ? "Applied and saved" : "Applied, NOT saved") << endl;
+        }
+
+        pros::delay(20);
     }
 }
\ No newline at end of file
@@ -0,0 +1,218 @@
+#include "thermal.h"
+#include "lemlib/api.hpp" // IWYU pragma: keep
+#include <cstdlib>
+#include "devices.h"
+
+namespace ThermalConfig {
+    // rough fit for an 11W motor: ~4 minutes from cold to throttle at the 2.5 A limit
+    const double WINDING_RESISTANCE = 1.0;
+    const double THERMAL_RESISTANCE = 9;
+    const double HEAT_CAPACITY = 33;
+    const double THROTTLE_TEMP = 55; // same as the overheating warning in motor_temp_task
+    const int HORIZON = 60000;
+    const double MIN_DERATE = 0.5;
+    const double UNLIMITED_SLEW = 20;
+    const double DRIVER_SLEW = 120; // 0 to full speed in 100 ms at full derate
+    const int UPDATE_RATE = 100;
+}
+
+const double CURRENT_SMOOTHING = 0.2; // ema weight of each new current sample for the time to throttle
+const double READING_STEP = 5; // the firmware reports temperature in 5 degree steps
+const double CORRECTION_GAIN = 0.1; // fraction of the gap to a disagreeing reading closed each update
+const double DERATE_HYSTERESIS = 0.05; // derate change needed before the chassis slew is changed again
+const double DEFAULT_AMBIENT = 25; // used if no motor could be read at startup
+
+const int DRIVE_MOTORS[] = {0, 1, 2, 3, 4, 5}; // LM1 to RM3
+
+double ThermalMonitor::readTemperature(ThermalMotor motor) {
+    int index = static_cast<int>(motor);
+    switch (motor) {
+        case ThermalMotor::LM1: case ThermalMotor::LM2: case ThermalMotor::LM3:
+            return left_motors.get_temperature(index);
+        case ThermalMotor::RM1: case ThermalMotor::RM2: case ThermalMotor::RM3:
+            return right_motors.get_temperature(index - 3);
+        case ThermalMotor::INT:
+            return intake.get_temperature();
+        case ThermalMotor::OC:
+            return oc_motor.get_temperature();
+        default:
+            return PROS_ERR_F;
+    }
+}
+
+double ThermalMonitor::readCurrent(ThermalMotor motor) {
+    int index = static_cast<int>(motor);
+    std::int32_t current;
+    switch (motor) {
+        case ThermalMotor::LM1: case ThermalMotor::LM2: case ThermalMotor::LM3:
+            current = left_motors.get_current_draw(index);
+            break;
+        case ThermalMotor::RM1: case ThermalMotor::RM2: case ThermalMotor::RM3:
+            current = right_motors.get_current_draw(index - 3);
+            break;
+        case ThermalMotor::INT:
+            current = intake.get_current_draw();
+            break;
+        case ThermalMotor::OC:
+            current = oc_motor.get_current_draw();
+            break;
+        default:
+            return 0;
+    }
+    // a motor that can't be read is treated as idle rather than heating
+    return current == PROS_ERR ? 0 : current / 1000.0;
+}
+
+void ThermalMonitor::update() {
+    TRACE_ZONE("Thermal");
+    constexpr int count = static_cast<int>(ThermalMotor::COUNT);
+
+    // read every motor before taking the lock so other tasks aren't held up by the reads
+    double readings[count];
+    double currents[count];
+    for (int i = 0; i < count; i++) {
+        readings[i] = readTemperature(static_cast<ThermalMotor>(i));
+        currents[i] = readCurrent(static_cast<ThermalMotor>(i));
+    }
+
+    int currentTime = pros::millis();
+    double newDerate;
+    {
+        std::lock_guard<pros::Mutex> lock(mutex);
+        double dt = lastUpdate < 0 ? 0 : (currentTime - lastUpdate) / 1000.0;
+        lastUpdate = currentTime;
+
+        // the coolest motor at startup is the closest thing to an air temperature reading
+        if (ambient == 0) {
+            ambient = INFINITY;
+            for (double reading : readings) {
+                if (std::isfinite(reading) && reading > 0) ambient = std::min(ambient, reading);
+            }
+            if (!std::isfinite(ambient)) ambient = DEFAULT_AMBIENT;
+        }
+
+        double tau = ThermalConfig::THERMAL_RESISTANCE * ThermalConfig::HEAT_CAPACITY;
+        for (int i = 0; i < count; i++) {
+            MotorState& state = motors[i];
+            bool valid = std::isfinite(readings[i]) && readings[i] > 0;
+            if (state.temperature == 0) {
+                state.temperature = valid ? readings[i] : ambient;
+            }
+
+            // heat in from the winding, out through the case
+            double heat = currents[i] * currents[i] * ThermalConfig::WINDING_RESISTANCE;
+            double cooling = (state.temperature - ambient) / ThermalConfig::THERMAL_RESISTANCE;
+            state.temperature += (heat - cooling) / ThermalConfig::HEAT_CAPACITY * dt;
+
+            // only trust the coarse reading when it disagrees by more than its step
+            if (valid && fabs(readings[i] - state.temperature) > READING_STEP / 2) {
+                state.temperature += CORRECTION_GAIN * (readings[i] - state.temperature);
+            }
+
+            // solve the first order model for when it crosses the throttle temperature at this load
+            state.current = lemlib::ema(currents[i], state.current, CURRENT_SMOOTHING);
+            double steadyState = ambient + state.current * state.current * ThermalConfig::WINDING_RESISTANCE *
+                                               ThermalConfig::THERMAL_RESISTANCE;
+            if (state.temperature >= ThermalConfig::THROTTLE_TEMP) {
+                state.timeToThrottle = 0;
+            } else if (steadyState <= ThermalConfig::THROTTLE_TEMP) {
+                state.timeToThrottle = -1;
+            } else {
+                double remaining = log((steadyState - state.temperature) / (steadyState - ThermalConfig::THROTTLE_TEMP));
+                state.timeToThrottle = tau * remaining * 1000;
+            }
+        }
+
+        // derate in proportion to how far inside the horizon the first drive motor would throttle
+        int timeToThrottle = -1;
+        for (int i : DRIVE_MOTORS) {
+            int motorTime = motors[i].timeToThrottle;
+            if (motorTime >= 0 && (timeToThrottle < 0 || motorTime < timeToThrottle)) timeToThrottle = motorTime;
+        }
+        newDerate = timeToThrottle < 0 ? 1
+                                       : std::clamp(static_cast<double>(timeToThrottle) / ThermalConfig::HORIZON,
+                                                    ThermalConfig::MIN_DERATE, 1.0);
+        derate = newDerate;
+    }
+
+    // outside of the lock since the chassis has its own
+    applyDerate(newDerate);
+}
+
+void ThermalMonitor::applyDerate(double newDerate) {
+    bool restoring = newDerate == 1 && appliedDerate != 1;
+    if (!restoring && fabs(newDerate - appliedDerate) < DERATE_HYSTERESIS) {
+        return;
+    }
+    appliedDerate = newDerate;
+
+    // lateral_controller and angular_controller hold the tuned settings, the chassis holds the derated ones
+    auto derated = [&](double slew) {
+        if (newDerate == 1) return slew;
+        return (slew == 0 ? ThermalConfig::UNLIMITED_SLEW : slew) * newDerate;
+    };
+    chassis.setSlew(derated(lateral_controller.slew), derated(angular_controller.slew));
+}
+
+double ThermalMonitor::getTemperature(ThermalMotor motor) {
+    std::lock_guard<pros::Mutex> lock(mutex);
+    return motors[static_cast<int>(motor)].temperature;
+}
+
+int ThermalMonitor::getTimeToThrottle(ThermalMotor motor) {
+    std::lock_guard<pros::Mutex> lock(mutex);
+    return motors[static_cast<int>(motor)].timeToThrottle;
+}
+
+double ThermalMonitor::getBudget(ThermalMotor motor) {
+    std::lock_guard<pros::Mutex> lock(mutex);
+    if (ambient == 0) {
+        return 1;
+    }
+    double headroom = ThermalConfig::THROTTLE_TEMP - motors[static_cast<int>(motor)].temperature;
+    return std::clamp(headroom / (ThermalConfig::THROTTLE_TEMP - ambient), 0.0, 1.0);
+}
+
+double ThermalMonitor::getDriveBudget() {
+    double budget = 1;
+    for (int i : DRIVE_MOTORS) {
+        budget = std::min(budget, getBudget(static_cast<ThermalMotor>(i)));
+    }
+    return budget;
+}
+
+int ThermalMonitor::getDriveTimeToThrottle() {
+    int timeToThrottle = -1;
+    for (int i : DRIVE_MOTORS) {
+        int motorTime = getTimeToThrottle(static_cast<ThermalMotor>(i));
+        if (motorTime >= 0 && (timeToThrottle < 0 || motorTime < timeToThrottle)) timeToThrottle = motorTime;
+    }
+    return timeToThrottle;
+}
+
+double ThermalMonitor::getDerate() {
+    std::lock_guard<pros::Mutex> lock(mutex);
+    return derate;
+}
+
+double ThermalMonitor::limitDriveAcceleration(double target, double current) {
+    double allowed = getDerate();
+    if (allowed >= 1) {
+        return target;
+    }
+    double maxChange = ThermalConfig::DRIVER_SLEW * allowed;
+    return current + std::clamp(target - current, -maxChange, maxChange);
+}
+
+// measures how late each thermal model update wakes and how long it runs
+LoopTimer thermalTimer("Thermal", ThermalConfig::UPDATE_RATE);
+
+// Task that keeps the thermal model of every motor up to date
+void thermal_task(void *param) {
+    while (true) {
+        thermal_monitor.update();
+
+        // Delay to save resources
+        thermalTimer.delay();
+    }
+}
@@ -0,0 +1,91 @@
+#include "trace.h"
+#include "lemlib/api.hpp" // IWYU pragma: keep
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "devices.h"
+
+namespace TraceConfig {
+    const char* TRACE_FILE = "/usd/trace.csv";
+}
+
+#if TRACE_ENABLED
+Tracer::TaskBuffer& Tracer::currentBuffer() {
+    pros::task_t current = pros::c::task_get_current();
+
+    for (TaskBuffer& buffer : buffers) {
+        if (buffer.ready.load(std::memory_order_acquire) && buffer.task == current) {
+            return buffer;
+        }
+    }
+
+    // first event from this task, claim a free buffer
+    for (TaskBuffer& buffer : buffers) {
+        bool expected = false;
+        if (buffer.claimed.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
+            buffer.task = current;
+            // copy the name since the task may be deleted before the dump
+            const char* name = pros::c::task_get_name(current);
+            strncpy(buffer.name, name == nullptr ? "?" : name, TraceConfig::NAME_LENGTH - 1);
+            buffer.ready.store(true, std::memory_order_release);
+            return buffer;
+        }
+    }
+    return buffers[TraceConfig::MAX_TASKS - 1];
+}
+
+void Tracer::record(const char* name, bool begin) {
+    if (paused.load(std::memory_order_relaxed)) {
+        return;
+    }
+    TaskBuffer& buffer = currentBuffer();
+    std::uint32_t head = buffer.head.load(std::memory_order_relaxed);
+    buffer.events[head % TraceConfig::EVENTS_PER_TASK] = {static_cast<std::uint32_t>(pros::micros()), name, begin};
+    buffer.head.store(head + 1, std::memory_order_release);
+}
+
+bool Tracer::dump(const char* path) {
+    FILE* file = fopen(path, "w");
+    if (file == nullptr) {
+        return false;
+    }
+
+    // let any event being written finish before reading
+    paused = true;
+    pros::delay(1);
+
+    fprintf(file, "task,task_name,phase,time_us,zone\n");
+    for (int id = 0; id < TraceConfig::MAX_TASKS; id++) {
+        TaskBuffer& buffer = buffers[id];
+        if (!buffer.ready) continue;
+        std::uint32_t head = buffer.head.load(std::memory_order_acquire);
+        std::uint32_t start = head > TraceConfig::EVENTS_PER_TASK ? head - TraceConfig::EVENTS_PER_TASK : 0;
+        for (std::uint32_t i = start; i < head; i++) {
+            const TraceEvent& event = buffer.events[i % TraceConfig::EVENTS_PER_TASK];
+            fprintf(file, "%d,%s,%c,%lu,%s\n", id, buffer.name, event.begin ? 'B' : 'E',
+                    static_cast<unsigned long>(event.time), event.name);
+        }
+        buffer.head = 0;
+    }
+    fclose(file);
+
+    paused = false;
+    return true;
+}
+
+TraceZone::TraceZone(const char* name) : name(name) {
+    tracer.record(name, true);
+}
+
+TraceZone::~TraceZone() {
+    tracer.record(name, false);
+}
+#endif
+
+bool dumpTrace() {
+#if TRACE_ENABLED
+    return pros::usd::is_installed() && tracer.dump(TraceConfig::TRACE_FILE);
+#else
+    return false;
+#endif
+}
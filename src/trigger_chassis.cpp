@@ -0,0 +1,322 @@
+#include "trigger_chassis.h"
+#include "lemlib/api.hpp" // IWYU pragma: keep
+#include <cstdlib>
+#include <memory>
+#include "devices.h"
+
+namespace TriggerConfig {
+    const int POLL_RATE = 5; // half of the lemlib motion loop so no trigger is more than a cycle late
+}
+
+namespace CalibrationConfig {
+    const int STILL_TIME = 1000;
+    const double MAX_DRIFT = 0.05; // a good V5 IMU sits around 0.01
+    const int READY_TIMEOUT = 5000; // lemlib retries a failed IMU calibration, so allow for one retry
+}
+
+const float STILL_DISTANCE = 0.25; // inches the robot can move during the drift window and still count as still
+
+void TriggerChassis::calibrateAsync() {
+    if (calibrating.exchange(true)) {
+        return;
+    }
+    pros::Task(calibration_task, this, "Calibration Task");
+}
+
+void TriggerChassis::runCalibration() {
+    int startTime = pros::millis();
+    lemlib::Chassis::calibrate();
+    calibrated = true;
+    int readyTime = pros::millis() - startTime;
+
+    // measure drift while nothing is moving, the robot is usually sitting on the field at this point
+    lemlib::Pose startPose = getPose();
+    pros::delay(CalibrationConfig::STILL_TIME);
+    lemlib::Pose endPose = getPose();
+    if (startPose.distance(endPose) > STILL_DISTANCE) {
+        pros::lcd::print(5, "IMU ready in %d ms, moved before drift check", readyTime);
+        return;
+    }
+    headingDrift = fabs(lemlib::angleError(endPose.theta, startPose.theta, false)) * 1000 /
+                   CalibrationConfig::STILL_TIME;
+    pros::lcd::print(5, "IMU ready in %d ms, drift %.3f deg/s", readyTime, headingDrift.load());
+    if (headingDrift > CalibrationConfig::MAX_DRIFT) {
+        pros::lcd::print(1, "WARN: IMU drifting %.2f deg/s, recalibrate", headingDrift.load());
+    }
+}
+
+bool TriggerChassis::isCalibrated() const {
+    return calibrated;
+}
+
+bool TriggerChassis::waitUntilCalibrated(int msecTimeout) {
+    // nothing to wait for if calibration was never started in the background
+    if (!calibrating) {
+        return calibrated;
+    }
+    int startTime = pros::millis(); // Record the start time of the function
+    while (!calibrated && pros::millis() - startTime < msecTimeout) {
+        pros::delay(10);
+    }
+    if (!calibrated) {
+        pros::lcd::print(1, "WARN: IMU still calibrating, moving without it");
+    }
+    return calibrated;
+}
+
+float TriggerChassis::getHeadingDrift() const {
+    return headingDrift;
+}
+
+void TriggerChassis::setPose(float x, float y, float theta, bool radians) {
+    waitUntilCalibrated();
+    lemlib::Chassis::setPose(x, y, theta, radians);
+}
+
+void TriggerChassis::setPose(lemlib::Pose pose, bool radians) {
+    waitUntilCalibrated();
+    lemlib::Chassis::setPose(pose, radians);
+}
+
+bool TriggerChassis::addTrigger(TriggerType type, float threshold, std::function<void()> action) {
+    std::lock_guard<pros::Mutex> lock(triggerMutex);
+
+    // find a free slot for the trigger
+    for (Trigger& trigger : triggers) {
+        if (trigger.state == TriggerState::EMPTY) {
+            trigger.type = type;
+            trigger.threshold = threshold;
+            trigger.action = std::move(action);
+            trigger.state = TriggerState::PENDING;
+            return true;
+        }
+    }
+
+    pros::lcd::print(1, "WARN: Motion trigger dropped b/c all slots are full");
+    return false;
+}
+
+bool TriggerChassis::atDistance(float dist, std::function<void()> action) {
+    return addTrigger(TriggerType::DISTANCE, dist, std::move(action));
+}
+
+bool TriggerChassis::atProgress(float fraction, std::function<void()> action) {
+    return addTrigger(TriggerType::PROGRESS, std::clamp(fraction, 0.0f, 1.0f), std::move(action));
+}
+
+bool TriggerChassis::atTime(int msec, std::function<void()> action) {
+    return addTrigger(TriggerType::TIME, msec, std::move(action));
+}
+
+void TriggerChassis::clearTriggers() {
+    std::lock_guard<pros::Mutex> lock(triggerMutex);
+    for (Trigger& trigger : triggers) {
+        if (trigger.state == TriggerState::PENDING || trigger.state == TriggerState::ACTIVE) {
+            trigger.state = TriggerState::EMPTY;
+            trigger.action = nullptr;
+        }
+    }
+}
+
+float TriggerChassis::getDistTraveled() const {
+    return distTraveled;
+}
+
+lemlib::ControllerSettings TriggerChassis::getLateralSettings() const {
+    return lateralSettings;
+}
+
+lemlib::ControllerSettings TriggerChassis::getAngularSettings() const {
+    return angularSettings;
+}
+
+// lemlib builds its PIDs and exit conditions with const members, so they are rebuilt in place
+void TriggerChassis::setLateralSettings(const lemlib::ControllerSettings& settings) {
+    lateralSettings = settings;
+    std::destroy_at(&lateralPID);
+    std::construct_at(&lateralPID, settings.kP, settings.kI, settings.kD, settings.windupRange, true);
+    std::destroy_at(&lateralSmallExit);
+    std::construct_at(&lateralSmallExit, settings.smallError, settings.smallErrorTimeout);
+    std::destroy_at(&lateralLargeExit);
+    std::construct_at(&lateralLargeExit, settings.largeError, settings.largeErrorTimeout);
+}
+
+void TriggerChassis::setAngularSettings(const lemlib::ControllerSettings& settings) {
+    angularSettings = settings;
+    std::destroy_at(&angularPID);
+    std::construct_at(&angularPID, settings.kP, settings.kI, settings.kD, settings.windupRange, true);
+    std::destroy_at(&angularSmallExit);
+    std::construct_at(&angularSmallExit, settings.smallError, settings.smallErrorTimeout);
+    std::destroy_at(&angularLargeExit);
+    std::construct_at(&angularLargeExit, settings.largeError, settings.largeErrorTimeout);
+}
+
+void TriggerChassis::setSlew(float lateralSlew, float angularSlew) {
+    lateralSettings.slew = lateralSlew;
+    angularSettings.slew = angularSlew;
+}
+
+// A motion called while another is running waits in lemlib's queue, so its start time is unknown until it returns
+int TriggerChassis::motionCallTime() {
+    // every wrapped motion comes through here first, so this is where they wait for the IMU
+    waitUntilCalibrated();
+    return isInMotion() ? -1 : pros::millis();
+}
+
+void TriggerChassis::startMotion(int callTime, float remaining) {
+    std::lock_guard<pros::Mutex> lock(triggerMutex);
+
+    // the async motion has already been running for a few ms by the time it returns
+    motionStartTime = callTime < 0 ? pros::millis() : callTime;
+    motionLength = remaining + std::max(getDistTraveled(), 0.0f);
+
+    for (Trigger& trigger : triggers) {
+        // a queued motion starts before the trigger task sees the last one end, so drop its leftovers here
+        if (trigger.state == TriggerState::ACTIVE) {
+            trigger.state = TriggerState::EMPTY;
+            trigger.action = nullptr;
+        }
+        // attach waiting triggers to this motion
+        else if (trigger.state == TriggerState::PENDING) {
+            trigger.state = TriggerState::ACTIVE;
+        }
+    }
+}
+
+void TriggerChassis::finishMotion(bool async) {
+    // motions are always started async so triggers can attach, block here if the caller asked for it
+    if (!async) {
+        waitUntilDone();
+    }
+}
+
+float TriggerChassis::turnLength(float theta, lemlib::AngularDirection direction) {
+    return fabs(lemlib::angleError(theta, getPose().theta, false, direction));
+}
+
+float TriggerChassis::pointHeading(float x, float y, bool forwards) {
+    lemlib::Pose pose = getPose();
+    float heading = lemlib::radToDeg(atan2(x - pose.x, y - pose.y));
+    return forwards ? heading : heading + 180;
+}
+
+void TriggerChassis::updateTriggers() {
+    TRACE_ZONE("Motion Triggers");
+    bool due[MAX_TRIGGERS] = {};
+
+    {
+        std::lock_guard<pros::Mutex> lock(triggerMutex);
+        bool moving = isInMotion();
+        float dist = getDistTraveled();
+        int elapsed = pros::millis() - motionStartTime;
+
+        for (int i = 0; i < MAX_TRIGGERS; i++) {
+            Trigger& trigger = triggers[i];
+            if (trigger.state != TriggerState::ACTIVE) continue;
+
+            // drop triggers that were never reached
+            if (!moving) {
+                trigger.state = TriggerState::EMPTY;
+                trigger.action = nullptr;
+                continue;
+            }
+
+            switch (trigger.type) {
+            case TriggerType::DISTANCE:
+                due[i] = dist >= trigger.threshold;
+                break;
+            case TriggerType::PROGRESS:
+                due[i] = dist >= trigger.threshold * motionLength;
+                break;
+            case TriggerType::TIME:
+                due[i] = elapsed >= trigger.threshold;
+                break;
+            }
+
+            if (due[i]) {
+                trigger.state = TriggerState::FIRING;
+            }
+        }
+    }
+
+    // fire outside of the lock so actions can add triggers of their own
+    for (int i = 0; i < MAX_TRIGGERS; i++) {
+        if (!due[i]) continue;
+
+        triggers[i].action();
+
+        std::lock_guard<pros::Mutex> lock(triggerMutex);
+        triggers[i].state = TriggerState::EMPTY;
+        triggers[i].action = nullptr;
+    }
+}
+
+void TriggerChassis::turnToPoint(float x, float y, int timeout, lemlib::TurnToPointParams params, bool async) {
+    TRACE_ZONE("turnToPoint"); // includes waiting on lemlib's motion mutex
+    int callTime = motionCallTime();
+    lemlib::Chassis::turnToPoint(x, y, timeout, params, true);
+    startMotion(callTime, turnLength(pointHeading(x, y, params.forwards), params.direction));
+    finishMotion(async);
+}
+
+void TriggerChassis::turnToHeading(float theta, int timeout, lemlib::TurnToHeadingParams params, bool async) {
+    TRACE_ZONE("turnToHeading");
+    int callTime = motionCallTime();
+    lemlib::Chassis::turnToHeading(theta, timeout, params, true);
+    startMotion(callTime, turnLength(theta, params.direction));
+    finishMotion(async);
+}
+
+void TriggerChassis::swingToHeading(float theta, lemlib::DriveSide lockedSide, int timeout,
+                                    lemlib::SwingToHeadingParams params, bool async) {
+    TRACE_ZONE("swingToHeading");
+    int callTime = motionCallTime();
+    lemlib::Chassis::swingToHeading(theta, lockedSide, timeout, params, true);
+    startMotion(callTime, turnLength(theta, params.direction));
+    finishMotion(async);
+}
+
+void TriggerChassis::swingToPoint(float x, float y, lemlib::DriveSide lockedSide, int timeout,
+                                  lemlib::SwingToPointParams params, bool async) {
+    TRACE_ZONE("swingToPoint");
+    int callTime = motionCallTime();
+    lemlib::Chassis::swingToPoint(x, y, lockedSide, timeout, params, true);
+    startMotion(callTime, turnLength(pointHeading(x, y, params.forwards), params.direction));
+    finishMotion(async);
+}
+
+void TriggerChassis::moveToPose(float x, float y, float theta, int timeout, lemlib::MoveToPoseParams params,
+                                bool async) {
+    TRACE_ZONE("moveToPose");
+    int callTime = motionCallTime();
+    lemlib::Chassis::moveToPose(x, y, theta, timeout, params, true);
+    // the boomerang curve is longer than the straight line, so progress triggers fire slightly early
+    startMotion(callTime, getPose().distance(lemlib::Pose(x, y)));
+    finishMotion(async);
+}
+
+void TriggerChassis::moveToPoint(float x, float y, int timeout, lemlib::MoveToPointParams params, bool async) {
+    TRACE_ZONE("moveToPoint");
+    int callTime = motionCallTime();
+    lemlib::Chassis::moveToPoint(x, y, timeout, params, true);
+    startMotion(callTime, getPose().distance(lemlib::Pose(x, y)));
+    finishMotion(async);
+}
+
+// Task that calibrates the chassis passed as param
+void calibration_task(void *param) {
+    static_cast<TriggerChassis*>(param)->runCalibration();
+}
+
+// measures how late each trigger poll wakes and how long it runs
+LoopTimer motionTriggerTimer("Motion Trigger", TriggerConfig::POLL_RATE);
+
+// Task that fires the triggers of the current chassis motion
+void motion_trigger_task(void *param) {
+    while (true) {
+        chassis.updateTriggers();
+
+        // Delay to save resources
+        motionTriggerTimer.delay();
+    }
+}
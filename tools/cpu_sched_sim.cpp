@@ -0,0 +1,208 @@
+// Host stand-in for the brain's scheduler to check the CPU accounting
+//
+// Runs a fixed priority preemptive scheduler with a 1 ms tick and round robin
+// between equal priorities, like FreeRTOS on the brain, over a table of
+// periodic tasks. Each timed task is measured the way its LoopTimer measures
+// it, from wake up to the next delay, and a lowest priority probe counts gaps
+// the way CpuMonitor::runProbe does, so the table shows how far each estimate
+// the robot reports is from the CPU time the simulator actually handed out.
+//
+// Build: make -C tools
+// Usage: tools/bin/cpu_sched_sim [tasks.csv] [--seconds 10]
+//   tasks.csv lines are name,priority,period_ms,run_us[,jitter_us[,timed]]
+//   run_us is a loop's "run us p50" from dumpLoopTimers, timed is 0 for tasks without a LoopTimer
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+// same as CpuConfig in src/cpu_monitor.cpp
+const int PROBE_SLICE = 9700;
+const int PROBE_GAP = 20;
+const int PROBE_PRIORITY = 1;
+
+struct SimTask {
+    std::string name;
+    int priority;
+    int period;     // ms
+    int run;        // us per cycle
+    int jitter = 0; // us, each cycle runs run +- jitter
+    bool timed = true;
+
+    // scheduler state
+    bool ready = true;
+    std::uint64_t order = 0; // position in its priority's round robin queue
+    std::int64_t wakeTick = 0;
+    int remaining = 0;
+
+    // what the loop timer sees
+    std::int64_t wakeTime = -1;
+    std::uint64_t measured = 0;
+
+    std::uint64_t used = 0; // us actually run
+};
+
+// rough costs of the robot's always-on loops, replace them with measured ones through a CSV
+std::vector<SimTask> defaultTasks() {
+    return {
+        {"PROS Daemon", 16, 2, 40, 10, false},
+        {"Motion Trigger", 9, 5, 30, 10},
+        {"Opcontrol", 8, 20, 400, 100},
+        {"LemLib Odom", 8, 10, 150, 30, false},
+        {"Auton Runtime", 8, 5, 10, 5},
+        {"Geofence", 8, 10, 40, 10},
+        {"Battery", 8, 10, 20, 5},
+        {"Thermal", 8, 100, 150, 30},
+        {"Power", 8, 20, 150, 30},
+        {"Intake Control", 8, 10, 60, 20},
+        {"Ring Tracker", 8, 10, 80, 20},
+        {"Resource Monitor", 8, 1000, 2000, 200},
+        {"CPU Monitor", 8, 1000, 300, 50},
+        {"Motor Temp", 8, 200, 3000, 500},
+    };
+}
+
+bool readTasks(const char* path, std::vector<SimTask>& tasks) {
+    FILE* file = fopen(path, "r");
+    if (file == nullptr) {
+        return false;
+    }
+    char line[256];
+    while (fgets(line, sizeof(line), file) != nullptr) {
+        char name[64];
+        int priority, period, run, jitter = 0, timed = 1;
+        int fields = sscanf(line, "%63[^,],%d,%d,%d,%d,%d", name, &priority, &period, &run, &jitter, &timed);
+        if (fields < 4 || line[0] == '#') continue;
+        tasks.push_back({name, priority, period, run, jitter, timed != 0});
+    }
+    fclose(file);
+    return !tasks.empty();
+}
+
+int main(int argc, char** argv) {
+    std::vector<SimTask> tasks;
+    int seconds = 10;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--seconds") == 0 && i + 1 < argc) {
+            seconds = atoi(argv[++i]);
+        }
+        else if (!readTasks(argv[i], tasks)) {
+            fprintf(stderr, "could not read tasks from %s\n", argv[i]);
+            return 1;
+        }
+    }
+    if (tasks.empty()) {
+        tasks = defaultTasks();
+    }
+
+    std::mt19937 random(4478);
+    auto cycleLength = [&](const SimTask& task) {
+        if (task.jitter == 0) return task.run;
+        return std::max(1, task.run + static_cast<int>(random() % (2 * task.jitter + 1)) - task.jitter);
+    };
+
+    std::uint64_t nextOrder = 0;
+    for (SimTask& task : tasks) {
+        task.remaining = cycleLength(task);
+        task.order = nextOrder++;
+    }
+
+    // the probe, separate since it spins rather than running a fixed amount
+    bool probeReady = true;
+    std::int64_t probeWakeTick = 0;
+    std::int64_t probeStart = -1, probeLast = -1;
+    std::uint64_t probeBusy = 0, probeSeen = 0, probeUsed = 0, idle = 0;
+
+    SimTask* running = nullptr;
+    std::int64_t end = static_cast<std::int64_t>(seconds) * 1000000;
+    for (std::int64_t now = 0; now < end; now++) {
+        if (now % 1000 == 0) {
+            std::int64_t tick = now / 1000;
+            for (SimTask& task : tasks) {
+                if (!task.ready && task.wakeTick <= tick) {
+                    task.ready = true;
+                    task.order = nextOrder++;
+                }
+            }
+            if (!probeReady && probeWakeTick <= tick) {
+                probeReady = true;
+            }
+            // time slicing, the running task goes behind any equal priority task that is ready
+            if (running != nullptr && running->ready) {
+                running->order = nextOrder++;
+            }
+        }
+
+        SimTask* next = nullptr;
+        for (SimTask& task : tasks) {
+            if (task.ready && (next == nullptr || task.priority > next->priority ||
+                               (task.priority == next->priority && task.order < next->order))) {
+                next = &task;
+            }
+        }
+        running = next;
+
+        if (running != nullptr) {
+            SimTask& task = *running;
+            if (task.wakeTime < 0) {
+                task.wakeTime = now; // the first micros read after its delay returns
+            }
+            task.used++;
+            if (--task.remaining == 0) {
+                if (task.timed) {
+                    task.measured += now + 1 - task.wakeTime;
+                }
+                task.wakeTime = -1;
+                task.ready = false;
+                task.wakeTick = (now + 1) / 1000 + task.period;
+                task.remaining = cycleLength(task);
+                running = nullptr;
+            }
+        }
+        else if (probeReady) {
+            probeUsed++;
+            if (probeStart < 0) {
+                probeStart = probeLast = now;
+            }
+            if (now - probeLast > PROBE_GAP) {
+                probeBusy += now - probeLast;
+            }
+            probeLast = now;
+            if (now - probeStart >= PROBE_SLICE) {
+                probeSeen += now - probeStart;
+                probeStart = -1;
+                probeReady = false;
+                probeWakeTick = now / 1000 + 1;
+            }
+        }
+        else {
+            idle++;
+        }
+    }
+
+    printf("%-20s | %4s | %6s | %7s | %7s | %7s\n", "task", "prio", "period", "true %", "timer %", "error");
+    double trueTotal = 0, timedTotal = 0;
+    for (const SimTask& task : tasks) {
+        double actual = 100.0 * task.used / end;
+        trueTotal += actual;
+        if (task.timed) {
+            double measured = 100.0 * task.measured / end;
+            timedTotal += measured;
+            printf("%-20s | %4d | %6d | %7.2f | %7.2f | %+7.2f\n", task.name.c_str(), task.priority, task.period, actual,
+                   measured, measured - actual);
+        }
+        else {
+            printf("%-20s | %4d | %6d | %7.2f | %7s |\n", task.name.c_str(), task.priority, task.period, actual,
+                   "untimed");
+        }
+    }
+    double probeTotal = probeSeen == 0 ? 100 : 100.0 * probeBusy / probeSeen;
+    printf("total: %.2f %% true, %.2f %% from the probe (%+.2f)\n", trueTotal, probeTotal, probeTotal - trueTotal);
+    printf("other: %.2f %% as the robot reports it\n", std::max(probeTotal - timedTotal, 0.0));
+    printf("probe watched %.1f %% of the time, idle task ran %.1f %%\n", 100.0 * probeSeen / end, 100.0 * idle / end);
+    return 0;
+}
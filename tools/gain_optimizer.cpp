@@ -0,0 +1,506 @@
+// Host tool that tunes the chassis ControllerSettings against a simulated drivetrain
+//
+// Every lemlib motion in the COMPETITION_ROUTINES routes is replayed on a model
+// of the drivetrain, using the same PID, slew and exit condition logic as
+// lemlib. A separable CMA-ES searches gains, slew and exit ranges/timeouts to
+// minimize total motion time while keeping every motion's end error under the
+// limits, with each generation's candidates spread across all cores.
+//
+// drivePID segments use their own controller and are not affected by these
+// settings, so only the chassis.* motions of each route are in the suite.
+//
+// Build: make -C tools
+// Usage: tools/bin/gain_optimizer [--generations N] [--threads N] [--seed N]
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <numeric>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+// * DRIVETRAIN MODEL
+// matches devices.cpp: 450 rpm, new 2.75" omnis, 11.1875" track width
+const double WHEEL_DIAMETER = 2.75;
+const double DRIVE_RPM = 450;
+const double TRACK_WIDTH = 11.1875;
+const double MAX_SPEED = DRIVE_RPM * WHEEL_DIAMETER * M_PI / 60; // inches per second
+const double MOTOR_TIME_CONSTANT = 0.12; // seconds for a side to reach 63% of commanded speed
+const double STATIC_OUTPUT = 6; // output out of 127 needed to overcome friction
+const double BATTERY_LEVELS[] = {1.0, 0.85}; // fraction of max speed at full and low charge
+const double LOOP_TIME = 0.01; // lemlib runs its motions every 10 ms
+
+// * LIMITS
+const double LATERAL_END_LIMIT = 1.0; // inches a drive may end from its target
+const double ANGULAR_END_LIMIT = 2.0; // degrees a turn may end from its target
+const double MISS_PENALTY = 5000; // ms added per limit a motion ends outside of
+
+struct Settings {
+    double kP, kI, kD, windupRange, smallError, smallErrorTimeout, largeError, largeErrorTimeout, slew;
+};
+
+// Starting settings from devices.cpp
+const Settings LATERAL_START = {11, 0, 6, 3, 1, 100, 2, 800, 20};
+const Settings ANGULAR_START = {2, 0, 10, 3, 1, 100, 3, 500, 0};
+
+// * ROUTE SUITE
+enum class MotionType {
+    SET_POSE,
+    TURN_TO_HEADING,
+    MOVE_TO_POINT
+};
+
+struct Motion {
+    MotionType type;
+    double x, y, theta; // target, theta only used by turns and setPose
+    int timeout;
+    bool forwards = true;
+};
+
+struct Route {
+    std::string name;
+    std::vector<Motion> motions;
+};
+
+Motion setPose(double x, double y, double theta) { return {MotionType::SET_POSE, x, y, theta, 0}; }
+Motion turn(double theta, int timeout) { return {MotionType::TURN_TO_HEADING, 0, 0, theta, timeout}; }
+Motion move(double x, double y, int timeout, bool forwards = true) {
+    return {MotionType::MOVE_TO_POINT, x, y, 0, timeout, forwards};
+}
+
+// Keep in step with the chassis.* calls of the routes in auton_routes.cpp
+std::vector<Route> buildSuite() {
+    std::vector<Route> suite;
+    suite.push_back({"Prog Skills",
+                     {setPose(-58, 0, 270), turn(358, 2000), turn(90, 2000), turn(125, 2000), turn(180, 2000),
+                      turn(270, 2000), turn(180, 2000), turn(45, 2000), turn(180, 2000), turn(180, 2000),
+                      turn(90, 2000), turn(55, 2000), turn(0, 2000), turn(274, 2000), turn(0, 2000),
+                      turn(135, 2000)}});
+    suite.push_back({"Safe AWP Left",
+                     {setPose(0, 0, 0), turn(90, 1000), turn(42, 1000), turn(180, 1000), turn(-10, 1000)}});
+    suite.push_back({"Safe AWP Right",
+                     {setPose(0, 0, 0), turn(-90, 1000), turn(-42, 1000), turn(-180, 1000), turn(-10, 1000)}});
+    suite.push_back({"Blue Goalside Sugar Rush",
+                     {setPose(0, 0, -90), turn(-275, 1000), turn(-320, 1000), turn(-180, 1000), turn(-270, 1000),
+                      turn(-190, 1000), turn(-90, 1000), turn(-225, 1000), turn(-270, 1000)}});
+    suite.push_back({"Red Goalside Sugar Rush",
+                     {setPose(0, 0, 90), turn(275, 1000), turn(320, 1000), turn(180, 1000), turn(270, 1000),
+                      turn(190, 1000), turn(90, 1000), turn(225, 1000), turn(270, 1000)}});
+    // nothing in COMPETITION_ROUTINES drives with lemlib yet, so the lateral controller is tuned
+    // on straight drives about as long as the ones in ringRush
+    suite.push_back({"Lateral Reference",
+                     {setPose(0, 0, 0), move(0, 48, 2000), move(0, 24, 1000, false), move(0, 36, 1000),
+                      move(0, 12, 1000, false), move(0, 18, 1000)}});
+    return suite;
+}
+
+// * SIMULATION
+double angleError(double target, double position) {
+    double error = fmod(target - position, 360);
+    if (error > 180) error -= 360;
+    if (error < -180) error += 360;
+    return error;
+}
+
+// lemlib's PID, the derivative is per loop rather than per second
+struct PID {
+    const Settings& settings;
+    double integral = 0, prevError = 0;
+    explicit PID(const Settings& settings) : settings(settings) {}
+    double update(double error) {
+        integral += error;
+        if ((error < 0) != (prevError < 0)) integral = 0;
+        if (fabs(error) > settings.windupRange && settings.windupRange != 0) integral = 0;
+        double derivative = error - prevError;
+        prevError = error;
+        return error * settings.kP + integral * settings.kI + derivative * settings.kD;
+    }
+};
+
+// lemlib's exit condition, done once the input stays within range for the time
+struct ExitCondition {
+    double range, time;
+    double startTime = -1;
+    bool done = false;
+    ExitCondition(double range, double time) : range(range), time(time) {}
+    bool update(double input, double now) {
+        if (fabs(input) > range) startTime = -1;
+        else if (startTime == -1) startTime = now;
+        else if (now >= startTime + time) done = true;
+        return done;
+    }
+};
+
+double slew(double target, double current, double maxChange) {
+    if (maxChange == 0) return target;
+    return current + std::clamp(target - current, -maxChange, maxChange);
+}
+
+struct Robot {
+    double x = 0, y = 0, theta = 0; // inches and degrees, heading clockwise from +y
+    double left = 0, right = 0;     // side speeds in inches per second
+    double leftCommand = 0, rightCommand = 0;
+    double battery = 1;
+
+    // one loop of the drivetrain with the command sent last loop
+    void step() {
+        auto sideTarget = [&](double command) {
+            if (fabs(command) < STATIC_OUTPUT) return 0.0;
+            return std::clamp(command, -127.0, 127.0) / 127 * MAX_SPEED * battery;
+        };
+        double alpha = LOOP_TIME / (MOTOR_TIME_CONSTANT + LOOP_TIME);
+        left += (sideTarget(leftCommand) - left) * alpha;
+        right += (sideTarget(rightCommand) - right) * alpha;
+
+        double speed = (left + right) / 2;
+        double heading = theta * M_PI / 180;
+        x += speed * sin(heading) * LOOP_TIME;
+        y += speed * cos(heading) * LOOP_TIME;
+        theta += (left - right) / TRACK_WIDTH * 180 / M_PI * LOOP_TIME;
+    }
+
+    void move(double leftPower, double rightPower) {
+        leftCommand = leftPower;
+        rightCommand = rightPower;
+    }
+};
+
+struct MotionResult {
+    double time; // ms
+    double endError;
+};
+
+MotionResult simulateTurn(Robot& robot, const Motion& motion, const Settings& angular) {
+    PID pid(angular);
+    ExitCondition smallExit(angular.smallError, angular.smallErrorTimeout);
+    ExitCondition largeExit(angular.largeError, angular.largeErrorTimeout);
+    double prevPower = 0, time = 0;
+
+    while (time < motion.timeout) {
+        double error = angleError(motion.theta, robot.theta);
+        bool small = smallExit.update(error, time);
+        bool large = largeExit.update(error, time);
+        if (small || large) break;
+
+        double power = std::clamp(pid.update(error), -127.0, 127.0);
+        power = slew(power, prevPower, angular.slew);
+        prevPower = power;
+        robot.move(power, -power);
+        robot.step();
+        time += LOOP_TIME * 1000;
+    }
+    robot.move(0, 0);
+    return {time, fabs(angleError(motion.theta, robot.theta))};
+}
+
+MotionResult simulateMove(Robot& robot, const Motion& motion, const Settings& lateral, const Settings& angular) {
+    PID lateralPID(lateral), angularPID(angular);
+    ExitCondition smallExit(lateral.smallError, lateral.smallErrorTimeout);
+    ExitCondition largeExit(lateral.largeError, lateral.largeErrorTimeout);
+    double prevLateral = 0, time = 0, maxSpeed = 127;
+    bool close = false;
+
+    auto lateralError = [&]() {
+        double dx = motion.x - robot.x, dy = motion.y - robot.y;
+        double toTarget = atan2(dx, dy) * 180 / M_PI;
+        return hypot(dx, dy) * cos(angleError(robot.theta, toTarget) * M_PI / 180);
+    };
+
+    while (time < motion.timeout) {
+        double dx = motion.x - robot.x, dy = motion.y - robot.y;
+        double distance = hypot(dx, dy);
+        // lemlib stops steering and caps its speed once it is close to the target
+        if (distance < 7.5 && !close) {
+            close = true;
+            maxSpeed = std::max(fabs(prevLateral), 60.0);
+        }
+
+        double error = lateralError();
+        bool small = smallExit.update(error, time);
+        bool large = largeExit.update(error, time);
+        if ((small || large) && close) break;
+
+        double heading = motion.forwards ? robot.theta : robot.theta + 180;
+        double angularOut = close ? 0 : angularPID.update(angleError(atan2(dx, dy) * 180 / M_PI, heading));
+        double lateralOut = lateralPID.update(error);
+        lateralOut = std::clamp(lateralOut, -maxSpeed, maxSpeed);
+        angularOut = std::clamp(angularOut, -maxSpeed, maxSpeed);
+        if (!close) lateralOut = slew(lateralOut, prevLateral, lateral.slew);
+        if (!motion.forwards && !close) lateralOut = std::min(lateralOut, 0.0);
+        if (motion.forwards && !close) lateralOut = std::max(lateralOut, 0.0);
+        prevLateral = lateralOut;
+
+        // desaturate so steering is kept when the sides would go over full power
+        double leftPower = lateralOut + angularOut, rightPower = lateralOut - angularOut;
+        double ratio = std::max(fabs(leftPower), fabs(rightPower)) / maxSpeed;
+        if (ratio > 1) {
+            leftPower /= ratio;
+            rightPower /= ratio;
+        }
+        robot.move(leftPower, rightPower);
+        robot.step();
+        time += LOOP_TIME * 1000;
+    }
+    robot.move(0, 0);
+    return {time, hypot(motion.x - robot.x, motion.y - robot.y)};
+}
+
+struct RouteResult {
+    double time = 0;     // ms spent in motions
+    double penalty = 0;  // ms added for motions that missed their limits
+    int misses = 0;
+    double worstLateral = 0, worstAngular = 0;
+};
+
+RouteResult simulateRoute(const Route& route, const Settings& lateral, const Settings& angular, double battery) {
+    RouteResult result;
+    Robot robot;
+    robot.battery = battery;
+
+    for (const Motion& motion : route.motions) {
+        if (motion.type == MotionType::SET_POSE) {
+            robot.x = motion.x;
+            robot.y = motion.y;
+            robot.theta = motion.theta;
+            continue;
+        }
+
+        bool turning = motion.type == MotionType::TURN_TO_HEADING;
+        MotionResult motionResult = turning ? simulateTurn(robot, motion, angular)
+                                            : simulateMove(robot, motion, lateral, angular);
+        // let the robot coast to a stop the way brake mode hold would between motions
+        for (int i = 0; i < 5; i++) robot.step();
+        robot.left = robot.right = 0;
+
+        double endError = turning ? fabs(angleError(motion.theta, robot.theta))
+                                  : hypot(motion.x - robot.x, motion.y - robot.y);
+        double limit = turning ? ANGULAR_END_LIMIT : LATERAL_END_LIMIT;
+        result.time += motionResult.time;
+        if (endError > limit) {
+            result.penalty += MISS_PENALTY * endError / limit;
+            result.misses++;
+        }
+        double& worst = turning ? result.worstAngular : result.worstLateral;
+        worst = std::max(worst, endError);
+
+        // pick up where the route would have put the robot so later motions are not thrown off
+        if (turning) robot.theta = motion.theta + std::clamp(angleError(robot.theta, motion.theta), -limit, limit);
+    }
+    return result;
+}
+
+// * SEARCH SPACE
+struct Parameter {
+    const char* name;
+    double min, max;
+};
+
+// lateral then angular, kI and windup range are left alone
+const Parameter PARAMETERS[] = {
+    {"lateral kP", 1, 40},         {"lateral kD", 0, 60},           {"lateral slew", 0, 127},
+    {"lateral smallError", 0.25, 3}, {"lateral smallErrorTimeout", 20, 500},
+    {"lateral largeError", 1, 8},    {"lateral largeErrorTimeout", 100, 1500},
+    {"angular kP", 0.2, 10},       {"angular kD", 0, 60},           {"angular slew", 0, 127},
+    {"angular smallError", 0.25, 5}, {"angular smallErrorTimeout", 20, 500},
+    {"angular largeError", 1, 10},   {"angular largeErrorTimeout", 100, 1500},
+};
+const int DIMENSIONS = sizeof(PARAMETERS) / sizeof(PARAMETERS[0]);
+
+using Point = std::vector<double>; // every parameter normalized to [0, 1]
+
+void decode(const Point& point, Settings& lateral, Settings& angular) {
+    auto value = [&](int i) { return PARAMETERS[i].min + std::clamp(point[i], 0.0, 1.0) * (PARAMETERS[i].max - PARAMETERS[i].min); };
+    lateral = {value(0), 0, value(1), LATERAL_START.windupRange, value(3), value(4), value(5), value(6), value(2)};
+    angular = {value(7), 0, value(8), ANGULAR_START.windupRange, value(10), value(11), value(12), value(13), value(9)};
+    // a large exit range tighter than the small one would never be the one that ends the motion
+    lateral.largeError = std::max(lateral.largeError, lateral.smallError);
+    angular.largeError = std::max(angular.largeError, angular.smallError);
+}
+
+Point encode(const Settings& lateral, const Settings& angular) {
+    double values[] = {lateral.kP, lateral.kD, lateral.slew, lateral.smallError, lateral.smallErrorTimeout,
+                       lateral.largeError, lateral.largeErrorTimeout, angular.kP, angular.kD, angular.slew,
+                       angular.smallError, angular.smallErrorTimeout, angular.largeError, angular.largeErrorTimeout};
+    Point point(DIMENSIONS);
+    for (int i = 0; i < DIMENSIONS; i++) {
+        point[i] = std::clamp((values[i] - PARAMETERS[i].min) / (PARAMETERS[i].max - PARAMETERS[i].min), 0.0, 1.0);
+    }
+    return point;
+}
+
+// total motion time plus penalties over every route at every battery level
+double evaluate(const std::vector<Route>& suite, const Point& point) {
+    Settings lateral, angular;
+    decode(point, lateral, angular);
+    double cost = 0;
+    for (double battery : BATTERY_LEVELS) {
+        for (const Route& route : suite) {
+            RouteResult result = simulateRoute(route, lateral, angular, battery);
+            cost += result.time + result.penalty;
+        }
+    }
+    return cost;
+}
+
+void evaluateAll(const std::vector<Route>& suite, const std::vector<Point>& points, std::vector<double>& costs,
+                 int threadCount) {
+    std::atomic<size_t> next(0);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threadCount; t++) {
+        workers.emplace_back([&]() {
+            for (size_t i = next++; i < points.size(); i = next++) {
+                costs[i] = evaluate(suite, points[i]);
+            }
+        });
+    }
+    for (std::thread& worker : workers) worker.join();
+}
+
+// * SEPARABLE CMA-ES
+// Diagonal covariance only, which needs no eigendecomposition and learns faster in this many dimensions
+Point optimize(const std::vector<Route>& suite, const Point& start, int generations, int threadCount,
+               unsigned seed) {
+    const int n = DIMENSIONS;
+    const int lambda = std::max(4 + (int)(3 * log(n)), threadCount);
+    const int mu = lambda / 2;
+
+    std::vector<double> weights(mu);
+    for (int i = 0; i < mu; i++) weights[i] = log(mu + 0.5) - log(i + 1);
+    double weightSum = std::accumulate(weights.begin(), weights.end(), 0.0);
+    for (double& weight : weights) weight /= weightSum;
+    double muEff = 1 / std::inner_product(weights.begin(), weights.end(), weights.begin(), 0.0);
+
+    const double cSigma = (muEff + 2) / (n + muEff + 5);
+    const double dSigma = 1 + 2 * std::max(0.0, sqrt((muEff - 1) / (n + 1)) - 1) + cSigma;
+    const double cC = (4 + muEff / n) / (n + 4 + 2 * muEff / n);
+    const double sepScale = (n + 2) / 3.0;
+    const double c1 = std::min(1.0, sepScale * 2 / ((n + 1.3) * (n + 1.3) + muEff));
+    const double cMu = std::min(1 - c1, sepScale * 2 * (muEff - 2 + 1 / muEff) / ((n + 2) * (n + 2) + muEff));
+    const double chiN = sqrt(n) * (1 - 1.0 / (4 * n) + 1.0 / (21.0 * n * n));
+
+    std::mt19937 rng(seed);
+    std::normal_distribution<double> normal(0, 1);
+
+    Point mean = start;
+    std::vector<double> variance(n, 1), pathSigma(n, 0), pathC(n, 0);
+    double sigma = 0.2;
+
+    Point best = start;
+    double bestCost = evaluate(suite, start);
+    printf("starting cost: %.0f\n", bestCost);
+
+    std::vector<Point> points(lambda, Point(n)), steps(lambda, Point(n));
+    std::vector<double> costs(lambda);
+    for (int generation = 0; generation < generations; generation++) {
+        for (int k = 0; k < lambda; k++) {
+            for (int i = 0; i < n; i++) {
+                steps[k][i] = sqrt(variance[i]) * normal(rng);
+                points[k][i] = std::clamp(mean[i] + sigma * steps[k][i], 0.0, 1.0);
+                // keep the step consistent with the clamped point so the update is not biased
+                steps[k][i] = (points[k][i] - mean[i]) / sigma;
+            }
+        }
+        evaluateAll(suite, points, costs, threadCount);
+
+        std::vector<int> order(lambda);
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [&](int a, int b) { return costs[a] < costs[b]; });
+        if (costs[order[0]] < bestCost) {
+            bestCost = costs[order[0]];
+            best = points[order[0]];
+        }
+
+        // move the mean toward the best candidates
+        std::vector<double> stepMean(n, 0);
+        for (int k = 0; k < mu; k++) {
+            for (int i = 0; i < n; i++) stepMean[i] += weights[k] * steps[order[k]][i];
+        }
+        for (int i = 0; i < n; i++) mean[i] = std::clamp(mean[i] + sigma * stepMean[i], 0.0, 1.0);
+
+        // evolution paths
+        double pathNorm = 0;
+        for (int i = 0; i < n; i++) {
+            pathSigma[i] = (1 - cSigma) * pathSigma[i] + sqrt(cSigma * (2 - cSigma) * muEff) * stepMean[i] / sqrt(variance[i]);
+            pathNorm += pathSigma[i] * pathSigma[i];
+        }
+        pathNorm = sqrt(pathNorm);
+        bool hSigma = pathNorm / sqrt(1 - pow(1 - cSigma, 2 * (generation + 1))) < (1.4 + 2.0 / (n + 1)) * chiN;
+        for (int i = 0; i < n; i++) {
+            pathC[i] = (1 - cC) * pathC[i] + (hSigma ? sqrt(cC * (2 - cC) * muEff) : 0) * stepMean[i];
+        }
+
+        // diagonal covariance and step size
+        for (int i = 0; i < n; i++) {
+            double rankMu = 0;
+            for (int k = 0; k < mu; k++) rankMu += weights[k] * steps[order[k]][i] * steps[order[k]][i];
+            double rankOne = pathC[i] * pathC[i] + (hSigma ? 0 : cC * (2 - cC) * variance[i]);
+            variance[i] = (1 - c1 - cMu) * variance[i] + c1 * rankOne + cMu * rankMu;
+        }
+        sigma *= exp(cSigma / dSigma * (pathNorm / chiN - 1));
+        sigma = std::min(sigma, 0.5);
+
+        printf("generation %3d | best %.0f | generation best %.0f | sigma %.4f\n", generation + 1, bestCost,
+               costs[order[0]], sigma);
+    }
+    return best;
+}
+
+// * REPORT
+void printReport(const std::vector<Route>& suite, const Settings& lateral, const Settings& angular, const char* label) {
+    printf("\n%s\n", label);
+    printf("%-32s | %9s | %9s | %6s | %11s | %11s\n", "route", "time ms", "low batt", "misses", "worst in", "worst deg");
+    for (const Route& route : suite) {
+        RouteResult full = simulateRoute(route, lateral, angular, BATTERY_LEVELS[0]);
+        RouteResult low = simulateRoute(route, lateral, angular, BATTERY_LEVELS[1]);
+        printf("%-32s | %9.0f | %9.0f | %6d | %11.2f | %11.2f\n", route.name.c_str(), full.time, low.time,
+               full.misses + low.misses, std::max(full.worstLateral, low.worstLateral),
+               std::max(full.worstAngular, low.worstAngular));
+    }
+}
+
+void printSettings(const char* name, const char* comment, const Settings& settings, const char* errorUnit) {
+    printf("// %s\n", comment);
+    printf("ControllerSettings %s(%.3g, // proportional gain (kP)\n", name, settings.kP);
+    int indent = (int)strlen("ControllerSettings ") + (int)strlen(name) + 1;
+    printf("%*s%.3g, // integral gain (kI)\n", indent, "", settings.kI);
+    printf("%*s%.3g, // derivative gain (kD)\n", indent, "", settings.kD);
+    printf("%*s%.3g, // anti windup\n", indent, "", settings.windupRange);
+    printf("%*s%.3g, // small error range, in %s\n", indent, "", settings.smallError, errorUnit);
+    printf("%*s%.0f, // small error range timeout, in milliseconds\n", indent, "", settings.smallErrorTimeout);
+    printf("%*s%.3g, // large error range, in %s\n", indent, "", settings.largeError, errorUnit);
+    printf("%*s%.0f, // large error range timeout, in milliseconds\n", indent, "", settings.largeErrorTimeout);
+    printf("%*s%.3g  // maximum acceleration (slew)\n", indent, "", settings.slew);
+    printf("%*s);\n", indent - 1, "");
+}
+
+int main(int argc, char** argv) {
+    int generations = 60;
+    int threadCount = std::max(1u, std::thread::hardware_concurrency());
+    unsigned seed = 4478;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "--generations") == 0) generations = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "--threads") == 0) threadCount = std::max(1, atoi(argv[i + 1]));
+        else if (strcmp(argv[i], "--seed") == 0) seed = atoi(argv[i + 1]);
+    }
+
+    std::vector<Route> suite = buildSuite();
+    printf("optimizing %d parameters over %zu routes on %d threads\n", DIMENSIONS, suite.size(), threadCount);
+
+    Point best = optimize(suite, encode(LATERAL_START, ANGULAR_START), generations, threadCount, seed);
+    Settings lateral, angular;
+    decode(best, lateral, angular);
+
+    printReport(suite, LATERAL_START, ANGULAR_START, "current settings (devices.cpp)");
+    printReport(suite, lateral, angular, "optimized settings");
+
+    printf("\n// paste into src/devices.cpp\n");
+    printSettings("lateral_controller", "lateral PID controller", lateral, "inches");
+    printf("\n");
+    printSettings("angular_controller", "angular PID controller", angular, "degrees");
+    return 0;
+}
@@ -0,0 +1,174 @@
+// Host tool that trains the ring classifier lookup table
+//
+// Reads the labeled samples the Record Ring Samples testing routine writes to
+// the SD card, counts how often each class lands in each table cell, and keeps
+// a cell's class only when there are enough samples and they mostly agree.
+// Empty cells next to trained ones take their neighbours' class so nearby
+// colors the recording missed still classify. Copy the output to the SD card as
+// ring_lut.bin and the robot loads it in initialize.
+//
+// Build: make -C tools
+// Usage: tools/bin/ring_lut_train ring_samples.csv ring_lut.bin [--min-count 5] [--purity 0.95]
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+// must match ClassifierConfig in include/ring_classifier.h
+const int CHROMA_BINS = 16;
+const int BRIGHTNESS_BINS = 4;
+const int PROXIMITY_BINS = 4;
+const int TABLE_SIZE = CHROMA_BINS * CHROMA_BINS * BRIGHTNESS_BINS * PROXIMITY_BINS;
+const int BRIGHTNESS_BITS_PER_BIN = 4;
+
+// must match RingClass
+enum { EMPTY, RED, BLUE, CLASSES };
+const char* CLASS_NAMES[CLASSES] = {"none", "red", "blue"};
+
+struct Sample {
+    int label;
+    int cell;
+};
+
+// same quantization as RingClassifier::cellIndex in src/ring_classifier.cpp
+int cellIndex(unsigned long clear, unsigned long red, unsigned long green, unsigned long blue, int proximity) {
+    double sum = static_cast<double>(red) + green + blue;
+    double redChroma = sum > 0 ? red / sum : 1.0 / 3;
+    double greenChroma = sum > 0 ? green / sum : 1.0 / 3;
+    int redBin = std::min(static_cast<int>(redChroma * CHROMA_BINS), CHROMA_BINS - 1);
+    int greenBin = std::min(static_cast<int>(greenChroma * CHROMA_BINS), CHROMA_BINS - 1);
+    int brightnessBin = std::min(static_cast<int>(log2(clear + 1.0)) / BRIGHTNESS_BITS_PER_BIN, BRIGHTNESS_BINS - 1);
+    int proximityBin = std::clamp(proximity * PROXIMITY_BINS / 256, 0, PROXIMITY_BINS - 1);
+    return ((proximityBin * BRIGHTNESS_BINS + brightnessBin) * CHROMA_BINS + redBin) * CHROMA_BINS + greenBin;
+}
+
+// fills untrained cells with the majority class of trained cells one bin away, a few passes so gaps close
+void fillGaps(std::uint8_t* table, std::vector<bool>& trained, int passes) {
+    for (int pass = 0; pass < passes; pass++) {
+        std::vector<bool> next = trained;
+        std::vector<std::uint8_t> filled(table, table + TABLE_SIZE);
+        for (int index = 0; index < TABLE_SIZE; index++) {
+            if (trained[index]) continue;
+            int green = index % CHROMA_BINS;
+            int red = index / CHROMA_BINS % CHROMA_BINS;
+            int rest = index / (CHROMA_BINS * CHROMA_BINS);
+            int votes[CLASSES] = {};
+            for (int dr = -1; dr <= 1; dr++) {
+                for (int dg = -1; dg <= 1; dg++) {
+                    int r = red + dr, g = green + dg;
+                    if ((dr == 0 && dg == 0) || r < 0 || g < 0 || r >= CHROMA_BINS || g >= CHROMA_BINS) continue;
+                    int neighbour = (rest * CHROMA_BINS + r) * CHROMA_BINS + g;
+                    if (trained[neighbour]) votes[table[neighbour]]++;
+                }
+            }
+            // only fill with a ring color when no neighbour says empty, a wrong EMPTY is cheaper than a wrong color
+            int best = votes[RED] > votes[BLUE] ? RED : BLUE;
+            if (votes[best] > 0 && votes[EMPTY] == 0 && votes[RED + BLUE - best] == 0) {
+                filled[index] = best;
+                next[index] = true;
+            }
+            else if (votes[EMPTY] > 0) {
+                next[index] = true;
+            }
+        }
+        std::copy(filled.begin(), filled.end(), table);
+        trained = next;
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        fprintf(stderr, "usage: %s ring_samples.csv ring_lut.bin [--min-count 5] [--purity 0.95]\n", argv[0]);
+        return 1;
+    }
+    int minCount = 5;
+    double purity = 0.95;
+    for (int i = 3; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "--min-count") == 0) minCount = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "--purity") == 0) purity = atof(argv[i + 1]);
+    }
+
+    FILE* file = fopen(argv[1], "r");
+    if (file == nullptr) {
+        fprintf(stderr, "could not open %s\n", argv[1]);
+        return 1;
+    }
+
+    std::vector<Sample> samples;
+    std::vector<int> counts(TABLE_SIZE * CLASSES, 0);
+    char line[256];
+    fgets(line, sizeof(line), file); // header
+    while (fgets(line, sizeof(line), file) != nullptr) {
+        char label[16];
+        unsigned long clear, red, green, blue;
+        int proximity;
+        if (sscanf(line, "%15[^,],%lu,%lu,%lu,%lu,%d", label, &clear, &red, &green, &blue, &proximity) != 6) {
+            continue;
+        }
+        int labelClass = -1;
+        for (int c = 0; c < CLASSES; c++) {
+            if (strcmp(label, CLASS_NAMES[c]) == 0) labelClass = c;
+        }
+        if (labelClass < 0) continue;
+        Sample sample = {labelClass, cellIndex(clear, red, green, blue, proximity)};
+        samples.push_back(sample);
+        counts[sample.cell * CLASSES + labelClass]++;
+    }
+    fclose(file);
+    if (samples.empty()) {
+        fprintf(stderr, "no samples in %s\n", argv[1]);
+        return 1;
+    }
+
+    // a cell keeps its majority class only when it's confident, otherwise it stays EMPTY
+    std::uint8_t table[TABLE_SIZE] = {};
+    std::vector<bool> trained(TABLE_SIZE, false);
+    int confident = 0, ambiguous = 0;
+    for (int index = 0; index < TABLE_SIZE; index++) {
+        int* cell = &counts[index * CLASSES];
+        int total = cell[EMPTY] + cell[RED] + cell[BLUE];
+        if (total == 0) continue;
+        int best = std::max_element(cell, cell + CLASSES) - cell;
+        trained[index] = true;
+        if (total >= minCount && cell[best] >= purity * total) {
+            table[index] = best;
+            confident++;
+        }
+        else {
+            ambiguous++;
+        }
+    }
+    fillGaps(table, trained, 2);
+
+    FILE* out = fopen(argv[2], "wb");
+    if (out == nullptr) {
+        fprintf(stderr, "could not write %s\n", argv[2]);
+        return 1;
+    }
+    const char magic[4] = {'R', 'L', 'U', 'T'};
+    std::uint8_t dims[4] = {CHROMA_BINS, CHROMA_BINS, BRIGHTNESS_BINS, PROXIMITY_BINS};
+    fwrite(magic, 1, 4, out);
+    fwrite(dims, 1, 4, out);
+    fwrite(table, 1, TABLE_SIZE, out);
+    fclose(out);
+
+    // confusion on the training samples, rows are labels and columns are what the table says
+    int confusion[CLASSES][CLASSES] = {};
+    int correct = 0;
+    for (const Sample& sample : samples) {
+        confusion[sample.label][table[sample.cell]]++;
+        if (table[sample.cell] == sample.label) correct++;
+    }
+    printf("%zu samples, %d confident cells, %d ambiguous cells left empty\n\n", samples.size(), confident, ambiguous);
+    printf("%-6s | %6s | %6s | %6s\n", "label", "none", "red", "blue");
+    for (int c = 0; c < CLASSES; c++) {
+        printf("%-6s | %6d | %6d | %6d\n", CLASS_NAMES[c], confusion[c][EMPTY], confusion[c][RED], confusion[c][BLUE]);
+    }
+    int wrongColor = confusion[RED][BLUE] + confusion[BLUE][RED] + confusion[EMPTY][RED] + confusion[EMPTY][BLUE];
+    printf("\naccuracy %.1f%%, wrong color %d\n", 100.0 * correct / samples.size(), wrongColor);
+    return 0;
+}
@@ -0,0 +1,121 @@
+// Host tool that fits feedforward constants from a sysid log
+//
+// Reads the CSV the Sysid testing routine writes to the SD card and fits
+// voltage = kS * sign(v) + kV * v + kA * a for linear and angular motion, the
+// same fit the robot runs. Useful for refitting with a different velocity
+// cutoff or after dropping a bad test.
+//
+// Build: make -C tools
+// Usage: tools/bin/sysid_fit sysid.csv [--min-velocity 0.5] [--skip quasistatic|dynamic]
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+struct Sample {
+    double voltage, velocity, acceleration;
+};
+
+struct Feedforward {
+    double kS = 0, kV = 0, kA = 0, rSquared = 0;
+    int samples = 0;
+    bool valid = false;
+};
+
+// ordinary least squares through the normal equations, matches fitFeedforward in src/sysid.cpp
+Feedforward fit(const std::vector<Sample>& samples, double minVelocity) {
+    Feedforward result;
+    double matrix[3][4] = {};
+    double voltageSum = 0, voltageSquares = 0;
+    for (const Sample& sample : samples) {
+        if (fabs(sample.velocity) < minVelocity) continue;
+        double row[3] = {sample.velocity > 0 ? 1.0 : -1.0, sample.velocity, sample.acceleration};
+        for (int r = 0; r < 3; r++) {
+            for (int c = 0; c < 3; c++) matrix[r][c] += row[r] * row[c];
+            matrix[r][3] += row[r] * sample.voltage;
+        }
+        voltageSum += sample.voltage;
+        voltageSquares += sample.voltage * sample.voltage;
+        result.samples++;
+    }
+    if (result.samples < 10) return result;
+
+    for (int col = 0; col < 3; col++) {
+        int pivot = col;
+        for (int r = col + 1; r < 3; r++) {
+            if (fabs(matrix[r][col]) > fabs(matrix[pivot][col])) pivot = r;
+        }
+        if (fabs(matrix[pivot][col]) < 1e-9) return result;
+        std::swap(matrix[col], matrix[pivot]);
+        for (int r = 0; r < 3; r++) {
+            if (r == col) continue;
+            double factor = matrix[r][col] / matrix[col][col];
+            for (int c = col; c < 4; c++) matrix[r][c] -= factor * matrix[col][c];
+        }
+    }
+    result.kS = matrix[0][3] / matrix[0][0];
+    result.kV = matrix[1][3] / matrix[1][1];
+    result.kA = matrix[2][3] / matrix[2][2];
+
+    double residualSquares = 0;
+    for (const Sample& sample : samples) {
+        if (fabs(sample.velocity) < minVelocity) continue;
+        double sign = sample.velocity > 0 ? 1 : -1;
+        double residual = sample.voltage - (result.kS * sign + result.kV * sample.velocity + result.kA * sample.acceleration);
+        residualSquares += residual * residual;
+    }
+    double mean = voltageSum / result.samples;
+    double totalSquares = voltageSquares - result.samples * mean * mean;
+    result.rSquared = totalSquares > 0 ? 1 - residualSquares / totalSquares : 0;
+    result.valid = result.kV > 0 && result.kA >= 0;
+    return result;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s sysid.csv [--min-velocity 0.5] [--skip quasistatic|dynamic]\n", argv[0]);
+        return 1;
+    }
+    double minVelocity = 0.5;
+    std::string skip;
+    for (int i = 2; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "--min-velocity") == 0) minVelocity = atof(argv[i + 1]);
+        else if (strcmp(argv[i], "--skip") == 0) skip = argv[i + 1];
+    }
+
+    FILE* file = fopen(argv[1], "r");
+    if (file == nullptr) {
+        fprintf(stderr, "could not open %s\n", argv[1]);
+        return 1;
+    }
+
+    std::vector<Sample> linear, angular;
+    char line[256];
+    fgets(line, sizeof(line), file); // header
+    while (fgets(line, sizeof(line), file) != nullptr) {
+        char motion[16], test[16], direction[16];
+        unsigned long time;
+        Sample sample;
+        if (sscanf(line, "%15[^,],%15[^,],%15[^,],%lu,%lf,%lf,%lf", motion, test, direction, &time, &sample.voltage,
+                   &sample.velocity, &sample.acceleration) != 7) {
+            continue;
+        }
+        if (skip == test) continue;
+        (strcmp(motion, "angular") == 0 ? angular : linear).push_back(sample);
+    }
+    fclose(file);
+
+    printf("%-8s | %8s | %8s | %8s | %6s | %7s\n", "motion", "kS mV", "kV", "kA", "r2", "samples");
+    for (auto& [name, samples] : {std::pair<const char*, std::vector<Sample>&>("linear", linear),
+                                  std::pair<const char*, std::vector<Sample>&>("angular", angular)}) {
+        Feedforward result = fit(samples, minVelocity);
+        printf("%-8s | %8.1f | %8.2f | %8.3f | %6.3f | %7d%s\n", name, result.kS, result.kV, result.kA,
+               result.rSquared, result.samples, result.valid ? "" : "  (fit failed)");
+    }
+    printf("\nkS in mV, kV in mV per in/s, kA in mV per in/s^2\n");
+    return 0;
+}
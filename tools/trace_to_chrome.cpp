@@ -0,0 +1,122 @@
+// Host tool that converts a robot trace into Chrome trace-event JSON
+//
+// Reads the CSV the robot writes to the SD card when built with TRACE=1 and
+// writes JSON that opens in Perfetto (ui.perfetto.dev) or chrome://tracing,
+// one track per task. Zones whose start was overwritten in the robot's ring
+// buffer are dropped so every track nests properly.
+//
+// Build: make -C tools
+// Usage: tools/bin/trace_to_chrome trace.csv trace.json
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+struct Event {
+    int task;
+    char phase;
+    std::uint64_t time;
+    std::string zone;
+};
+
+// escape a string for a JSON value
+std::string escape(const std::string& text) {
+    std::string out;
+    for (char c : text) {
+        if (c == '"' || c == '\\') out += '\\';
+        out += c;
+    }
+    return out;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        fprintf(stderr, "usage: %s trace.csv trace.json\n", argv[0]);
+        return 1;
+    }
+
+    FILE* file = fopen(argv[1], "r");
+    if (file == nullptr) {
+        fprintf(stderr, "could not open %s\n", argv[1]);
+        return 1;
+    }
+
+    std::vector<Event> events;
+    std::map<int, std::string> taskNames;
+    char line[256];
+    fgets(line, sizeof(line), file); // header
+    while (fgets(line, sizeof(line), file) != nullptr) {
+        int task;
+        char name[64], phase, zone[64];
+        unsigned long time;
+        if (sscanf(line, "%d,%63[^,],%c,%lu,%63[^\r\n]", &task, name, &phase, &time, zone) != 5) {
+            continue;
+        }
+        taskNames[task] = name;
+        events.push_back({task, phase, time, zone});
+    }
+    fclose(file);
+    if (events.empty()) {
+        fprintf(stderr, "no events in %s\n", argv[1]);
+        return 1;
+    }
+
+    // the robot's microsecond clock is 32 bits, unwrap it if the trace spans a wrap
+    std::uint64_t earliest = UINT64_MAX, latest = 0;
+    for (const Event& event : events) {
+        earliest = std::min(earliest, event.time);
+        latest = std::max(latest, event.time);
+    }
+    if (latest - earliest > (1ull << 31)) {
+        for (Event& event : events) {
+            if (event.time < (1ull << 31)) event.time += 1ull << 32;
+        }
+        earliest = UINT64_MAX;
+        for (const Event& event : events) earliest = std::min(earliest, event.time);
+    }
+
+    // each task's events are in order already, sort keeps that for equal times
+    std::stable_sort(events.begin(), events.end(),
+                     [](const Event& a, const Event& b) { return a.time < b.time; });
+
+    FILE* out = fopen(argv[2], "w");
+    if (out == nullptr) {
+        fprintf(stderr, "could not write %s\n", argv[2]);
+        return 1;
+    }
+    fprintf(out, "{\"traceEvents\":[\n");
+    bool first = true;
+    for (const auto& [task, name] : taskNames) {
+        fprintf(out, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\"}}",
+                first ? "" : ",\n", task, escape(name).c_str());
+        first = false;
+    }
+
+    std::map<int, int> depth;
+    int written = 0, dropped = 0;
+    for (const Event& event : events) {
+        if (event.phase == 'E') {
+            if (depth[event.task] == 0) {
+                dropped++;
+                continue;
+            }
+            depth[event.task]--;
+        }
+        else {
+            depth[event.task]++;
+        }
+        fprintf(out, ",\n{\"name\":\"%s\",\"ph\":\"%c\",\"pid\":1,\"tid\":%d,\"ts\":%llu}", escape(event.zone).c_str(),
+                event.phase, event.task, static_cast<unsigned long long>(event.time - earliest));
+        written++;
+    }
+    fprintf(out, "\n]}\n");
+    fclose(out);
+
+    printf("%d events from %zu tasks over %.3f s, %d unmatched ends dropped\n", written, taskNames.size(),
+           (latest - earliest) / 1e6, dropped);
+    return 0;
+}